@@ -13,6 +13,8 @@
 ** 修改日期         修改作者        修改内容
 ** 2022年5月29日    付瑞彪          创建文件，初次版本
 ** 2022年7月15日    付瑞彪          修改代码注释规范
+** 2026年10月18日   付瑞彪          增加可选的轻量格式化输出
+** 2026年10月18日   付瑞彪          增加无符号整数打印
 **
 ***********************************************************************************************************************/
 
@@ -24,6 +26,10 @@
 #include <stddef.h>
 #include <string.h>
 #include <stdlib.h>
+#if LETK_CLI_FMT_ENABLE
+#include <stdarg.h>
+#include "letk_fmt.h"
+#endif  /* LETK_CLI_FMT_ENABLE */
 
 /* 输入状态定义 */
 typedef enum
@@ -162,6 +168,9 @@ void letk_cli_put_char(const char ch)
 /* 打印整数 */
 void letk_cli_put_int(const int num)
 {
+#if LETK_CLI_FMT_ENABLE
+    (void)letk_fmt_printf_cb(letk_cli_put_char, "%d", num);
+#else   /* LETK_CLI_FMT_ENABLE */
     char buf[10];
     int i = 0;
     int temp = num;
@@ -182,6 +191,30 @@ void letk_cli_put_int(const int num)
     {
         letk_cli_put_char(buf[--i]);
     }
+#endif  /* LETK_CLI_FMT_ENABLE */
+}
+
+/* 打印无符号整数 */
+void letk_cli_put_uint(const unsigned long num)
+{
+#if LETK_CLI_FMT_ENABLE
+    (void)letk_fmt_printf_cb(letk_cli_put_char, "%lu", num);
+#else   /* LETK_CLI_FMT_ENABLE */
+    char buf[20];
+    int i = 0;
+    unsigned long temp = num;
+
+    do
+    {
+        buf[i++] = (char)(temp % 10u) + '0';
+        temp /= 10u;
+    } while (temp);
+
+    while (i)
+    {
+        letk_cli_put_char(buf[--i]);
+    }
+#endif  /* LETK_CLI_FMT_ENABLE */
 }
 
 /* 打印字符串 */
@@ -202,6 +235,25 @@ void letk_cli_put_str(const char* const str)
     }
 }
 
+#if LETK_CLI_FMT_ENABLE
+/* 格式化打印 */
+int letk_cli_printf(const char* fmt, ...)
+{
+    va_list args;
+    int count;
+
+    if (letk_cli_mgr.pf_outchar == NULL)
+    {
+        return 0;
+    }
+
+    va_start(args, fmt);
+    count = letk_fmt_vprintf_cb(letk_cli_mgr.pf_outchar, fmt, args);
+    va_end(args);
+    return count;
+}
+#endif  /* LETK_CLI_FMT_ENABLE */
+
 /**
  * @brief 保存当前上下文内容并清除当前行的显示内容
  */
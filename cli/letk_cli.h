@@ -13,6 +13,8 @@
 ** 修改日期         修改作者        修改内容
 ** 2022年5月29日    付瑞彪          创建文件，初次版本
 ** 2022年7月15日    付瑞彪          修改代码注释规范
+** 2026年10月18日   付瑞彪          增加可选的轻量格式化输出
+** 2026年10月18日   付瑞彪          增加无符号整数打印
 **
 ***********************************************************************************************************************/
 #ifndef __LETK_CLI_H__
@@ -23,6 +25,11 @@
 
 #if LETK_CLI_ENABLE
 
+/* 默认不使用轻量格式化 */
+#ifndef LETK_CLI_FMT_ENABLE
+#define LETK_CLI_FMT_ENABLE             0u
+#endif  /* LETK_CLI_FMT_ENABLE */
+
 #ifdef __cplusplus
 extern "C" {
 #endif  /* __cplusplus */
@@ -122,12 +129,28 @@ void letk_cli_put_char(const char ch);
  */
 void letk_cli_put_int(const int num);
 
+/**
+ * @brief 打印无符号整数
+ * @param[in] num 待打印的无符号整形数据
+ */
+void letk_cli_put_uint(const unsigned long num);
+
 /**
  * @brief 打印字符串
  * @param[in] str 待打印的字符串
  */
 void letk_cli_put_str(const char* const str);
 
+#if LETK_CLI_FMT_ENABLE
+/**
+ * @brief 格式化打印，支持的格式参考letk_fmt
+ * @param[in] fmt 格式化字符串
+ * @param[in] ... 可变参数
+ * @return 打印的字符数
+ */
+int letk_cli_printf(const char* fmt, ...);
+#endif  /* LETK_CLI_FMT_ENABLE */
+
 /**
  * @brief 保存当前上下文内容并清除当前行的显示内容
  */
@@ -13,6 +13,7 @@
 ** 修改日期         修改作者        修改内容
 ** 2022年5月29日    付瑞彪          创建文件，初次版本
 ** 2022年7月15日    付瑞彪          修改代码注释规范
+** 2026年10月18日   付瑞彪          增加可选的轻量格式化输出
 **
 ***********************************************************************************************************************/
 #ifndef __LETK_CLI_CFG_H__
@@ -41,6 +42,9 @@
 /* 最大的备份行数，用于历史记录 */
 #define LETK_CLI_HISTORY_LINE_MAX       10u
 
+/* 是否使用letk_fmt轻量格式化，使能后提供letk_cli_printf，整数输出也使用letk_fmt，需要加入fmt模块 */
+#define LETK_CLI_FMT_ENABLE             0u
+
 /* 默认命令提示符 */
 #define LETK_CLI_DEFAULT_CMD_PROMPT     "[LETX] > "
 
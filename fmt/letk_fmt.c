@@ -0,0 +1,568 @@
+/***********************************************************************************************************************
+** 文件描述：轻量格式化输出源文件，不依赖stdio、locale和堆，可重入
+** 创建作者：付瑞彪(Tom Free)
+** 创建日期：2026年10月18日
+** 编码格式：UTF-8编码
+** 编程语言：C语言，C99标准
+** 缩进格式：4个空格键
+** 命名规范：下划线命名法(小写命名法)
+** 开源许可：MIT许可证，参考：https://mit-license.org
+** 版权信息：Copyright (c) 2013-2022, Tom Free, <tomfreefu@gmail.com>
+**
+** 修改记录
+** 修改日期         修改作者        修改内容
+** 2026年10月18日   付瑞彪          创建文件，初次版本
+**
+***********************************************************************************************************************/
+#include "letk_fmt.h"
+#include <stdint.h>
+#include <limits.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif  /* __cplusplus */
+
+/* 标志 */
+#define LETK_FMT_FLAG_LEFT      0x01u   /* '-'，左对齐 */
+#define LETK_FMT_FLAG_ZERO      0x02u   /* '0'，补0 */
+#define LETK_FMT_FLAG_PLUS      0x04u   /* '+'，正数输出+ */
+#define LETK_FMT_FLAG_SPACE     0x08u   /* ' '，正数输出空格 */
+#define LETK_FMT_FLAG_ALT       0x10u   /* '#'，十六进制输出0x */
+
+/* 长度修饰 */
+enum
+{
+    LETK_FMT_LEN_NONE,          /* 无 */
+    LETK_FMT_LEN_HH,            /* hh */
+    LETK_FMT_LEN_H,             /* h */
+    LETK_FMT_LEN_L,             /* l */
+    LETK_FMT_LEN_LL,            /* ll */
+    LETK_FMT_LEN_J,             /* j */
+    LETK_FMT_LEN_Z,             /* z */
+    LETK_FMT_LEN_T,             /* t */
+    LETK_FMT_LEN_BIG_L,         /* L */
+};
+
+/* 整数转换使用的类型 */
+#if LETK_FMT_LONG_LONG_ENABLE
+typedef long long letk_fmt_int_t;
+typedef unsigned long long letk_fmt_uint_t;
+#else   /* LETK_FMT_LONG_LONG_ENABLE */
+typedef long letk_fmt_int_t;
+typedef unsigned long letk_fmt_uint_t;
+#endif  /* LETK_FMT_LONG_LONG_ENABLE */
+
+/* 输出目标，在调用者栈上，保证可重入 */
+typedef struct
+{
+    char* buf;                      /* 缓存 */
+    size_t size;                    /* 缓存大小 */
+    size_t count;                   /* 已输出的字符数 */
+    letk_fmt_putc_cb_t* putc_cb;    /* 字符输出回调函数，NULL表示输出到缓存 */
+} letk_fmt_out_t;
+
+/* 格式说明符 */
+typedef struct
+{
+    uint8_t flags;                  /* 标志 */
+    uint8_t length;                 /* 长度修饰 */
+    int width;                      /* 宽度 */
+    int precision;                  /* 精度，-1表示未指定 */
+} letk_fmt_spec_t;
+
+/**
+ * @brief 输出一个字符，缓存满时只计数
+ * @param[in] po 输出目标
+ * @param[in] ch 字符
+ */
+static void letk_fmt_put(letk_fmt_out_t* po, char ch)
+{
+    if (po->putc_cb != NULL)
+    {
+        po->putc_cb(ch);
+    }
+    else if (po->count + 1 < po->size)
+    {
+        po->buf[po->count] = ch;
+    }
+    po->count++;
+}
+
+/**
+ * @brief 重复输出一个字符
+ * @param[in] po 输出目标
+ * @param[in] ch 字符
+ * @param[in] n 次数，不大于0时不输出
+ */
+static void letk_fmt_fill(letk_fmt_out_t* po, char ch, int n)
+{
+    while (n-- > 0)
+    {
+        letk_fmt_put(po, ch);
+    }
+}
+
+/**
+ * @brief 取标志字符对应的标志位
+ * @param[in] ch 字符
+ * @return 标志位，0表示不是标志字符
+ */
+static uint8_t letk_fmt_flag(char ch)
+{
+    switch (ch)
+    {
+    case '-': return LETK_FMT_FLAG_LEFT;
+    case '0': return LETK_FMT_FLAG_ZERO;
+    case '+': return LETK_FMT_FLAG_PLUS;
+    case ' ': return LETK_FMT_FLAG_SPACE;
+    case '#': return LETK_FMT_FLAG_ALT;
+    default:  return 0;
+    }
+}
+
+/**
+ * @brief 按宽度和对齐方式输出一个转换结果
+ * @param[in] po 输出目标
+ * @param[in] ps 说明符
+ * @param[in] prefix 符号或0x前缀
+ * @param[in] zeros 精度要求的前导0个数
+ * @param[in] body 内容
+ * @param[in] len 内容长度
+ */
+static void letk_fmt_put_field(letk_fmt_out_t* po, const letk_fmt_spec_t* ps, const char* prefix,
+                               int zeros, const char* body, int len)
+{
+    const char* p;
+    int pad = ps->width - zeros - len;
+
+    for (p = prefix; *p != '\0'; p++)
+    {
+        pad--;
+    }
+
+    if ((ps->flags & (LETK_FMT_FLAG_LEFT | LETK_FMT_FLAG_ZERO)) == 0)
+    {
+        letk_fmt_fill(po, ' ', pad);
+    }
+    while (*prefix != '\0')
+    {
+        letk_fmt_put(po, *prefix++);
+    }
+    if ((ps->flags & (LETK_FMT_FLAG_LEFT | LETK_FMT_FLAG_ZERO)) == LETK_FMT_FLAG_ZERO)
+    {
+        /* 补0在符号和前缀之后 */
+        letk_fmt_fill(po, '0', pad);
+    }
+    letk_fmt_fill(po, '0', zeros);
+    while (len-- > 0)
+    {
+        letk_fmt_put(po, *body++);
+    }
+    if (ps->flags & LETK_FMT_FLAG_LEFT)
+    {
+        letk_fmt_fill(po, ' ', pad);
+    }
+}
+
+/**
+ * @brief 输出一个整数
+ * @param[in] po 输出目标
+ * @param[in] ps 说明符
+ * @param[in] prefix 符号或0x前缀
+ * @param[in] value 数值的绝对值
+ * @param[in] conv 转换字符，'d'按十进制，'o'按八进制，其他按十六进制
+ */
+static void letk_fmt_put_uint(letk_fmt_out_t* po, letk_fmt_spec_t* ps, const char* prefix,
+                              letk_fmt_uint_t value, char conv)
+{
+    /* 64位十进制最多20位 */
+    char digits[sizeof(letk_fmt_uint_t) * 3];
+    char* p = &digits[sizeof(digits)];
+    const char* hex = (conv == 'X') ? "0123456789ABCDEF" : "0123456789abcdef";
+    unsigned long low;
+    int len;
+
+    if ((value == 0) && (ps->precision == 0))
+    {
+        /* 精度为0时数值0不输出数字 */
+    }
+    else if (conv == 'o')
+    {
+        do
+        {
+            *--p = (char)('0' + (int)(value & 0x07u));
+            value >>= 3;
+        } while (value != 0);
+    }
+    else if (conv != 'd')
+    {
+        /* 十六进制只需要移位 */
+        do
+        {
+            *--p = hex[value & 0x0Fu];
+            value >>= 4;
+        } while (value != 0);
+    }
+    else
+    {
+#if LETK_FMT_LONG_LONG_ENABLE && (ULLONG_MAX > ULONG_MAX)
+        /* 只有超出long的高位部分使用64位除法 */
+        while (value > ULONG_MAX)
+        {
+            *--p = (char)('0' + (int)(value % 10u));
+            value /= 10u;
+        }
+#endif  /* LETK_FMT_LONG_LONG_ENABLE && (ULLONG_MAX > ULONG_MAX) */
+        low = (unsigned long)value;
+        do
+        {
+            *--p = (char)('0' + (int)(low % 10u));
+            low /= 10u;
+        } while (low != 0);
+    }
+
+    len = (int)(&digits[sizeof(digits)] - p);
+    if (ps->precision >= 0)
+    {
+        /* 指定精度时忽略补0标志 */
+        ps->flags &= (uint8_t)~LETK_FMT_FLAG_ZERO;
+    }
+    if ((conv == 'o') && (ps->flags & LETK_FMT_FLAG_ALT) && ((len == 0) || (*p != '0')) && (ps->precision <= len))
+    {
+        /* '#'保证八进制以0开头 */
+        ps->precision = len + 1;
+    }
+    letk_fmt_put_field(po, ps, prefix, (ps->precision > len) ? (ps->precision - len) : 0, p, len);
+}
+
+/**
+ * @brief 按长度修饰读取有符号整数参数
+ * @param[in] length 长度修饰
+ * @param[in] pargs 可变参数列表
+ * @return 参数值
+ */
+static letk_fmt_int_t letk_fmt_arg_signed(uint8_t length, va_list* pargs)
+{
+    switch (length)
+    {
+    case LETK_FMT_LEN_HH: return (signed char)va_arg(*pargs, int);
+    case LETK_FMT_LEN_H:  return (short)va_arg(*pargs, int);
+    case LETK_FMT_LEN_L:  return va_arg(*pargs, long);
+    case LETK_FMT_LEN_LL: return (letk_fmt_int_t)va_arg(*pargs, long long);
+    case LETK_FMT_LEN_J:  return (letk_fmt_int_t)va_arg(*pargs, intmax_t);
+    case LETK_FMT_LEN_Z:
+    case LETK_FMT_LEN_T:  return (letk_fmt_int_t)va_arg(*pargs, ptrdiff_t);
+    default:              return va_arg(*pargs, int);
+    }
+}
+
+/**
+ * @brief 按长度修饰读取无符号整数参数
+ * @param[in] length 长度修饰
+ * @param[in] pargs 可变参数列表
+ * @return 参数值
+ */
+static letk_fmt_uint_t letk_fmt_arg_unsigned(uint8_t length, va_list* pargs)
+{
+    switch (length)
+    {
+    case LETK_FMT_LEN_HH: return (unsigned char)va_arg(*pargs, unsigned int);
+    case LETK_FMT_LEN_H:  return (unsigned short)va_arg(*pargs, unsigned int);
+    case LETK_FMT_LEN_L:  return va_arg(*pargs, unsigned long);
+    case LETK_FMT_LEN_LL: return (letk_fmt_uint_t)va_arg(*pargs, unsigned long long);
+    case LETK_FMT_LEN_J:  return (letk_fmt_uint_t)va_arg(*pargs, uintmax_t);
+    case LETK_FMT_LEN_Z:
+    case LETK_FMT_LEN_T:  return (letk_fmt_uint_t)va_arg(*pargs, size_t);
+    default:              return va_arg(*pargs, unsigned int);
+    }
+}
+
+/**
+ * @brief 格式化输出
+ * @param[in] po 输出目标
+ * @param[in] fmt 格式化字符串
+ * @param[in] pargs 可变参数列表
+ */
+static void letk_fmt_format(letk_fmt_out_t* po, const char* fmt, va_list* pargs)
+{
+    letk_fmt_spec_t spec;
+    letk_fmt_int_t value;
+    letk_fmt_uint_t uvalue;
+    const char* start;
+    const char* str;
+    uint8_t flag;
+    char ch;
+    int len;
+
+    for (;;)
+    {
+        /* 原样输出普通字符 */
+        while ((*fmt != '\0') && (*fmt != '%'))
+        {
+            letk_fmt_put(po, *fmt++);
+        }
+        if (*fmt == '\0')
+        {
+            break;
+        }
+        start = fmt++;
+
+        /* 标志 */
+        spec.flags = 0;
+        while ((flag = letk_fmt_flag(*fmt)) != 0)
+        {
+            spec.flags |= flag;
+            fmt++;
+        }
+        /* 宽度，负宽度表示左对齐 */
+        spec.width = 0;
+        if (*fmt == '*')
+        {
+            fmt++;
+            spec.width = va_arg(*pargs, int);
+            if (spec.width < 0)
+            {
+                spec.flags |= LETK_FMT_FLAG_LEFT;
+                spec.width = -spec.width;
+            }
+        }
+        while ((*fmt >= '0') && (*fmt <= '9'))
+        {
+            spec.width = spec.width * 10 + (*fmt++ - '0');
+        }
+        /* 精度，负精度表示未指定 */
+        spec.precision = -1;
+        if (*fmt == '.')
+        {
+            fmt++;
+            spec.precision = 0;
+            if (*fmt == '*')
+            {
+                fmt++;
+                spec.precision = va_arg(*pargs, int);
+                if (spec.precision < 0)
+                {
+                    spec.precision = -1;
+                }
+            }
+            while ((*fmt >= '0') && (*fmt <= '9'))
+            {
+                spec.precision = spec.precision * 10 + (*fmt++ - '0');
+            }
+        }
+        /* 长度修饰 */
+        spec.length = LETK_FMT_LEN_NONE;
+        switch (*fmt)
+        {
+        case 'h':
+            fmt++;
+            spec.length = LETK_FMT_LEN_H;
+            if (*fmt == 'h')
+            {
+                fmt++;
+                spec.length = LETK_FMT_LEN_HH;
+            }
+            break;
+        case 'l':
+            fmt++;
+            spec.length = LETK_FMT_LEN_L;
+            if (*fmt == 'l')
+            {
+                fmt++;
+                spec.length = LETK_FMT_LEN_LL;
+            }
+            break;
+        case 'j': fmt++; spec.length = LETK_FMT_LEN_J; break;
+        case 'z': fmt++; spec.length = LETK_FMT_LEN_Z; break;
+        case 't': fmt++; spec.length = LETK_FMT_LEN_T; break;
+        case 'L': fmt++; spec.length = LETK_FMT_LEN_BIG_L; break;
+        default: break;
+        }
+
+        /* 转换 */
+        ch = *fmt;
+        if (ch != '\0')
+        {
+            fmt++;
+        }
+        switch (ch)
+        {
+        case 'd':
+        case 'i':
+            value = letk_fmt_arg_signed(spec.length, pargs);
+            if (value < 0)
+            {
+                /* 先转为无符号再取反，最小负数也不会溢出 */
+                letk_fmt_put_uint(po, &spec, "-", (letk_fmt_uint_t)0 - (letk_fmt_uint_t)value, 'd');
+            }
+            else
+            {
+                letk_fmt_put_uint(po, &spec, (spec.flags & LETK_FMT_FLAG_PLUS) ? "+" :
+                                  (spec.flags & LETK_FMT_FLAG_SPACE) ? " " : "",
+                                  (letk_fmt_uint_t)value, 'd');
+            }
+            break;
+        case 'u':
+            letk_fmt_put_uint(po, &spec, "", letk_fmt_arg_unsigned(spec.length, pargs), 'd');
+            break;
+        case 'o':
+        case 'x':
+        case 'X':
+            uvalue = letk_fmt_arg_unsigned(spec.length, pargs);
+            letk_fmt_put_uint(po, &spec, ((spec.flags & LETK_FMT_FLAG_ALT) && (uvalue != 0) && (ch != 'o')) ?
+                              ((ch == 'x') ? "0x" : "0X") : "", uvalue, ch);
+            break;
+        case 'p':
+            letk_fmt_put_uint(po, &spec, "0x", (letk_fmt_uint_t)(uintptr_t)va_arg(*pargs, void*), 'x');
+            break;
+        case 'c':
+            ch = (char)va_arg(*pargs, int);
+            spec.flags &= (uint8_t)~LETK_FMT_FLAG_ZERO;
+            letk_fmt_put_field(po, &spec, "", 0, &ch, 1);
+            break;
+        case 's':
+            str = va_arg(*pargs, const char*);
+            if (str == NULL)
+            {
+                str = "(null)";
+            }
+            /* 指定精度时不能读取精度之外的字符 */
+            for (len = 0; ((spec.precision < 0) || (len < spec.precision)) && (str[len] != '\0'); len++)
+            {
+            }
+            spec.flags &= (uint8_t)~LETK_FMT_FLAG_ZERO;
+            letk_fmt_put_field(po, &spec, "", 0, str, len);
+            break;
+        case '%':
+            letk_fmt_put(po, '%');
+            break;
+        case 'n':
+            (void)va_arg(*pargs, void*);
+            break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            /* 不支持浮点数，读取参数保证后续参数正确，原样输出说明符 */
+            if (spec.length == LETK_FMT_LEN_BIG_L)
+            {
+                (void)va_arg(*pargs, long double);
+            }
+            else
+            {
+                (void)va_arg(*pargs, double);
+            }
+            /* fall through */
+        default:
+            /* 不支持的说明符原样输出 */
+            while (start < fmt)
+            {
+                letk_fmt_put(po, *start++);
+            }
+            break;
+        }
+    }
+}
+
+/**
+ * @brief 格式化到缓存，与vsnprintf用法相同
+ * @param[out] buf 缓存，size为0时可以为NULL
+ * @param[in] size 缓存大小，包括结束符
+ * @param[in] fmt 格式化字符串
+ * @param[in] args 可变参数列表
+ * @return 不截断时应输出的字符数，不包括结束符
+ */
+int letk_fmt_vsnprintf(char* buf, size_t size, const char* fmt, va_list args)
+{
+    letk_fmt_out_t out;
+    va_list ap;
+
+    out.buf = buf;
+    out.size = size;
+    out.count = 0;
+    out.putc_cb = NULL;
+
+    /* 复制一份，va_list是数组类型时参数不能直接取地址 */
+    va_copy(ap, args);
+    letk_fmt_format(&out, fmt, &ap);
+    va_end(ap);
+
+    if (size > 0)
+    {
+        buf[(out.count < size) ? out.count : (size - 1)] = '\0';
+    }
+    return (int)out.count;
+}
+
+/**
+ * @brief 格式化到缓存，与snprintf用法相同
+ * @param[out] buf 缓存，size为0时可以为NULL
+ * @param[in] size 缓存大小，包括结束符
+ * @param[in] fmt 格式化字符串
+ * @param[in] ... 可变参数
+ * @return 不截断时应输出的字符数，不包括结束符
+ */
+int letk_fmt_snprintf(char* buf, size_t size, const char* fmt, ...)
+{
+    va_list args;
+    int count;
+
+    va_start(args, fmt);
+    count = letk_fmt_vsnprintf(buf, size, fmt, args);
+    va_end(args);
+    return count;
+}
+
+/**
+ * @brief 格式化并逐个字符输出，不需要缓存
+ * @param[in] putc_cb 字符输出回调函数
+ * @param[in] fmt 格式化字符串
+ * @param[in] args 可变参数列表
+ * @return 输出的字符数
+ */
+int letk_fmt_vprintf_cb(letk_fmt_putc_cb_t* putc_cb, const char* fmt, va_list args)
+{
+    letk_fmt_out_t out;
+    va_list ap;
+
+    if (putc_cb == NULL)
+    {
+        return 0;
+    }
+
+    out.buf = NULL;
+    out.size = 0;
+    out.count = 0;
+    out.putc_cb = putc_cb;
+
+    va_copy(ap, args);
+    letk_fmt_format(&out, fmt, &ap);
+    va_end(ap);
+    return (int)out.count;
+}
+
+/**
+ * @brief 格式化并逐个字符输出，不需要缓存
+ * @param[in] putc_cb 字符输出回调函数
+ * @param[in] fmt 格式化字符串
+ * @param[in] ... 可变参数
+ * @return 输出的字符数
+ */
+int letk_fmt_printf_cb(letk_fmt_putc_cb_t* putc_cb, const char* fmt, ...)
+{
+    va_list args;
+    int count;
+
+    va_start(args, fmt);
+    count = letk_fmt_vprintf_cb(putc_cb, fmt, args);
+    va_end(args);
+    return count;
+}
+
+#ifdef __cplusplus
+}
+#endif  /* __cplusplus */
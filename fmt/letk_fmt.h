@@ -0,0 +1,80 @@
+/***********************************************************************************************************************
+** 文件描述：轻量格式化输出头文件，不依赖stdio、locale和堆，可重入
+** 创建作者：付瑞彪(Tom Free)
+** 创建日期：2026年10月18日
+** 编码格式：UTF-8编码
+** 编程语言：C语言，C99标准
+** 缩进格式：4个空格键
+** 命名规范：下划线命名法(小写命名法)
+** 开源许可：MIT许可证，参考：https://mit-license.org
+** 版权信息：Copyright (c) 2013-2022, Tom Free, <tomfreefu@gmail.com>
+**
+** 修改记录
+** 修改日期         修改作者        修改内容
+** 2026年10月18日   付瑞彪          创建文件，初次版本
+**
+***********************************************************************************************************************/
+#ifndef __LETK_FMT_H__
+#define __LETK_FMT_H__
+
+#include "letk_fmt_cfg.h"
+#include <stddef.h>
+#include <stdarg.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif  /* __cplusplus */
+
+/* 默认支持64位整数 */
+#ifndef LETK_FMT_LONG_LONG_ENABLE
+#define LETK_FMT_LONG_LONG_ENABLE       1
+#endif  /* LETK_FMT_LONG_LONG_ENABLE */
+
+/* 字符输出回调函数 */
+typedef void letk_fmt_putc_cb_t(const char ch);
+
+/**
+ * @brief 格式化到缓存，与vsnprintf用法相同
+ * @param[out] buf 缓存，size为0时可以为NULL
+ * @param[in] size 缓存大小，包括结束符
+ * @param[in] fmt 格式化字符串
+ * @param[in] args 可变参数列表
+ * @return 不截断时应输出的字符数，不包括结束符
+ * @note 支持%d %i %u %o %x %X %c %s %p %%，标志'-' '0' '+' ' '，宽度、精度和'*'，
+ *       长度修饰hh h l ll j z t，浮点数等其他说明符读取参数后原样输出说明符本身
+ */
+int letk_fmt_vsnprintf(char* buf, size_t size, const char* fmt, va_list args);
+
+/**
+ * @brief 格式化到缓存，与snprintf用法相同
+ * @param[out] buf 缓存，size为0时可以为NULL
+ * @param[in] size 缓存大小，包括结束符
+ * @param[in] fmt 格式化字符串
+ * @param[in] ... 可变参数
+ * @return 不截断时应输出的字符数，不包括结束符
+ */
+int letk_fmt_snprintf(char* buf, size_t size, const char* fmt, ...);
+
+/**
+ * @brief 格式化并逐个字符输出，不需要缓存
+ * @param[in] putc_cb 字符输出回调函数
+ * @param[in] fmt 格式化字符串
+ * @param[in] args 可变参数列表
+ * @return 输出的字符数
+ */
+int letk_fmt_vprintf_cb(letk_fmt_putc_cb_t* putc_cb, const char* fmt, va_list args);
+
+/**
+ * @brief 格式化并逐个字符输出，不需要缓存
+ * @param[in] putc_cb 字符输出回调函数
+ * @param[in] fmt 格式化字符串
+ * @param[in] ... 可变参数
+ * @return 输出的字符数
+ */
+int letk_fmt_printf_cb(letk_fmt_putc_cb_t* putc_cb, const char* fmt, ...);
+
+#ifdef __cplusplus
+}
+#endif  /* __cplusplus */
+
+#endif  /* __LETK_FMT_H__ */
@@ -0,0 +1,196 @@
+/***********************************************************************************************************************
+** 文件描述：轻量格式化输出基准测试，在主机上与C库的snprintf比较每次调用的耗时
+** 创建作者：付瑞彪(Tom Free)
+** 创建日期：2026年10月18日
+** 编码格式：UTF-8编码
+** 编程语言：C语言，C99标准
+** 缩进格式：4个空格键
+** 命名规范：下划线命名法(小写命名法)
+** 开源许可：MIT许可证，参考：https://mit-license.org
+** 版权信息：Copyright (c) 2013-2022, Tom Free, <tomfreefu@gmail.com>
+**
+** 修改记录
+** 修改日期         修改作者        修改内容
+** 2026年10月18日   付瑞彪          创建文件，初次版本
+**
+***********************************************************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+
+#include "letk_fmt.h"
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* 默认每个场景的调用次数，可由第一个命令行参数指定 */
+#define BENCH_CALLS_DEFAULT     1000000u
+
+/* 格式化函数，vsnprintf或letk_fmt_vsnprintf */
+typedef int bench_vsnprintf_t(char* buf, size_t size, const char* fmt, va_list args);
+
+/* 测试场景 */
+typedef struct
+{
+    const char* name;           /* 场景名称 */
+    int (*run)(bench_vsnprintf_t* fn, char* buf, size_t size, uint32_t i);  /* 格式化一次 */
+} bench_case_t;
+
+/* 防止调用被优化掉 */
+static volatile int bench_sink;
+
+/**
+ * @brief 获取单调时钟的ns时间戳
+ * @return ns时间戳
+ */
+static uint64_t bench_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief 通过指定的格式化函数格式化到缓存
+ * @param[in] fn 格式化函数
+ * @param[out] buf 缓存
+ * @param[in] size 缓存大小
+ * @param[in] fmt 格式化字符串
+ * @return 格式化后的长度
+ */
+static int bench_format(bench_vsnprintf_t* fn, char* buf, size_t size, const char* fmt, ...)
+{
+    va_list args;
+    int len;
+
+    va_start(args, fmt);
+    len = fn(buf, size, fmt, args);
+    va_end(args);
+    return len;
+}
+
+/**
+ * @brief 典型日志行，字符串、无符号、定宽十六进制和有符号混合
+ * @param[in] fn 格式化函数
+ * @param[out] buf 缓存
+ * @param[in] size 缓存大小
+ * @param[in] i 循环序号，用于变化参数
+ * @return 格式化后的长度
+ */
+static int bench_case_log(bench_vsnprintf_t* fn, char* buf, size_t size, uint32_t i)
+{
+    return bench_format(fn, buf, size, "rx %s len=%u crc=%08x err=%d id=%5d",
+                        "uart1", (unsigned int)i, (unsigned int)(i * 2654435761u), -(int)i, (int)(i & 0xFFFFu));
+}
+
+/**
+ * @brief 只有十进制整数
+ * @param[in] fn 格式化函数
+ * @param[out] buf 缓存
+ * @param[in] size 缓存大小
+ * @param[in] i 循环序号，用于变化参数
+ * @return 格式化后的长度
+ */
+static int bench_case_dec(bench_vsnprintf_t* fn, char* buf, size_t size, uint32_t i)
+{
+    return bench_format(fn, buf, size, "%d %u %ld", (int)i, (unsigned int)i * 7u, (long)i * -13L);
+}
+
+/**
+ * @brief 只有十六进制整数
+ * @param[in] fn 格式化函数
+ * @param[out] buf 缓存
+ * @param[in] size 缓存大小
+ * @param[in] i 循环序号，用于变化参数
+ * @return 格式化后的长度
+ */
+static int bench_case_hex(bench_vsnprintf_t* fn, char* buf, size_t size, uint32_t i)
+{
+    return bench_format(fn, buf, size, "%x %08X %#lx", (unsigned int)i, (unsigned int)i * 7u, (unsigned long)i << 4);
+}
+
+/**
+ * @brief 只有字符串和字符
+ * @param[in] fn 格式化函数
+ * @param[out] buf 缓存
+ * @param[in] size 缓存大小
+ * @param[in] i 循环序号，用于变化参数
+ * @return 格式化后的长度
+ */
+static int bench_case_str(bench_vsnprintf_t* fn, char* buf, size_t size, uint32_t i)
+{
+    return bench_format(fn, buf, size, "[%s] %-8s|%c", "letk", (i & 1u) ? "ok" : "fail", 'A' + (int)(i % 26u));
+}
+
+/**
+ * @brief 64位整数
+ * @param[in] fn 格式化函数
+ * @param[out] buf 缓存
+ * @param[in] size 缓存大小
+ * @param[in] i 循环序号，用于变化参数
+ * @return 格式化后的长度
+ */
+static int bench_case_ll(bench_vsnprintf_t* fn, char* buf, size_t size, uint32_t i)
+{
+    return bench_format(fn, buf, size, "%llu %lld", (unsigned long long)i * 1000000007ull, -(long long)i * 998244353ll);
+}
+
+/* 全部测试场景 */
+static const bench_case_t bench_cases[] =
+{
+    { "log", bench_case_log },
+    { "dec", bench_case_dec },
+    { "hex", bench_case_hex },
+    { "str", bench_case_str },
+    { "ll", bench_case_ll },
+};
+
+/**
+ * @brief 运行一个场景，测量平均每次调用的耗时
+ * @param[in] pc 测试场景
+ * @param[in] fn 格式化函数
+ * @param[in] calls 调用次数
+ * @return 平均每次调用的ns数
+ */
+static double bench_run(const bench_case_t* pc, bench_vsnprintf_t* fn, uint32_t calls)
+{
+    char buf[128];
+    uint64_t begin;
+    uint32_t i;
+    int sum = 0;
+
+    begin = bench_ns();
+    for (i = 0; i < calls; i++)
+    {
+        sum += pc->run(fn, buf, sizeof(buf), i);
+    }
+    bench_sink = sum;
+    return (double)(bench_ns() - begin) / calls;
+}
+
+/**
+ * @brief 主函数
+ * @param[in] argc 参数数量
+ * @param[in] argv 参数列表，argv[1]为每个场景的调用次数
+ * @return 0
+ */
+int main(int argc, char* argv[])
+{
+    uint32_t calls = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : BENCH_CALLS_DEFAULT;
+    double libc, letk;
+    size_t n;
+
+    if (calls == 0)
+    {
+        calls = BENCH_CALLS_DEFAULT;
+    }
+
+    for (n = 0; n < sizeof(bench_cases) / sizeof(bench_cases[0]); n++)
+    {
+        libc = bench_run(&bench_cases[n], vsnprintf, calls);
+        letk = bench_run(&bench_cases[n], letk_fmt_vsnprintf, calls);
+        printf("%-4s vsnprintf=%.1fns letk_fmt_vsnprintf=%.1fns\n", bench_cases[n].name, libc, letk);
+    }
+    return 0;
+}
@@ -0,0 +1,230 @@
+/***********************************************************************************************************************
+** 文件描述：轻量格式化输出差分测试，在主机上与C库的snprintf逐字节对比输出和返回值
+** 创建作者：付瑞彪(Tom Free)
+** 创建日期：2026年10月18日
+** 编码格式：UTF-8编码
+** 编程语言：C语言，C99标准
+** 缩进格式：4个空格键
+** 命名规范：下划线命名法(小写命名法)
+** 开源许可：MIT许可证，参考：https://mit-license.org
+** 版权信息：Copyright (c) 2013-2022, Tom Free, <tomfreefu@gmail.com>
+**
+** 修改记录
+** 修改日期         修改作者        修改内容
+** 2026年10月18日   付瑞彪          创建文件，初次版本
+**
+***********************************************************************************************************************/
+#include "letk_fmt.h"
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/* 对比C库snprintf和letk_fmt_snprintf的输出和返回值，不一致时记录失败 */
+#define TEST_DIFF(...)                                                                          \
+    do                                                                                          \
+    {                                                                                           \
+        char expect[128];                                                                       \
+        char actual[128];                                                                       \
+        int expect_len = snprintf(expect, sizeof(expect), __VA_ARGS__);                         \
+        int actual_len = letk_fmt_snprintf(actual, sizeof(actual), __VA_ARGS__);                \
+        test_check((expect_len == actual_len) && (strcmp(expect, actual) == 0), __LINE__,       \
+                   expect, expect_len, actual, actual_len);                                     \
+        test_count++;                                                                           \
+    } while (0)
+
+/* 标志组合 */
+static const char* const test_flags[] = { "", "-", "0", "+", " ", "-0", "+0", "#", "#0", "-+" };
+/* 宽度 */
+static const char* const test_widths[] = { "", "1", "5", "12", "25" };
+/* 精度 */
+static const char* const test_precs[] = { "", ".", ".0", ".3", ".15" };
+/* 整数取值 */
+static const long long test_values[] = { 0, 1, -1, 42, -42, 255, INT_MAX, INT_MIN, 123456789, -987654321 };
+
+/* 对比次数 */
+static unsigned long test_count;
+/* 失败次数 */
+static unsigned long test_fails;
+/* 回调输出的缓存 */
+static char test_cb_buf[64];
+/* 回调输出的字符数 */
+static size_t test_cb_len;
+
+/**
+ * @brief 记录一次对比结果，失败时打印期望值和实际值
+ * @param[in] ok 是否一致
+ * @param[in] line 行号
+ * @param[in] expect 期望的输出
+ * @param[in] expect_len 期望的返回值
+ * @param[in] actual 实际的输出
+ * @param[in] actual_len 实际的返回值
+ */
+static void test_check(int ok, int line, const char* expect, int expect_len, const char* actual, int actual_len)
+{
+    if (!ok)
+    {
+        if (test_fails++ < 20u)
+        {
+            printf("FAIL line %d: expect [%s] %d, actual [%s] %d\n", line, expect, expect_len, actual, actual_len);
+        }
+    }
+}
+
+/**
+ * @brief 字符输出回调，输出到测试缓存
+ * @param[in] ch 字符
+ */
+static void test_putc(const char ch)
+{
+    if (test_cb_len < sizeof(test_cb_buf) - 1u)
+    {
+        test_cb_buf[test_cb_len++] = ch;
+    }
+}
+
+/**
+ * @brief 判断标志组合中是否包含某个标志
+ * @param[in] flags 标志组合
+ * @param[in] flag 标志
+ * @return 是否包含
+ */
+static int test_has_flag(const char* flags, char flag)
+{
+    return (strchr(flags, flag) != NULL);
+}
+
+/**
+ * @brief 标志、宽度、精度、长度修饰和转换的全部组合逐一对比
+ * @note 跳过C标准中未定义的组合：#用于有符号十进制，0、+、空格和#用于%s和%c，精度用于%c
+ */
+static void test_matrix(void)
+{
+    static const char convs[] = "diuoxX";
+    char fmt[32];
+    const char* flags;
+    const char* width;
+    const char* prec;
+    long long value;
+    size_t fi, wi, pi, vi, ci;
+
+    for (fi = 0; fi < sizeof(test_flags) / sizeof(test_flags[0]); fi++)
+    {
+        flags = test_flags[fi];
+        for (wi = 0; wi < sizeof(test_widths) / sizeof(test_widths[0]); wi++)
+        {
+            width = test_widths[wi];
+            for (pi = 0; pi < sizeof(test_precs) / sizeof(test_precs[0]); pi++)
+            {
+                prec = test_precs[pi];
+                for (vi = 0; vi < sizeof(test_values) / sizeof(test_values[0]); vi++)
+                {
+                    value = test_values[vi];
+                    for (ci = 0; convs[ci] != '\0'; ci++)
+                    {
+                        if (test_has_flag(flags, '#') && (strchr("diu", convs[ci]) != NULL))
+                        {
+                            continue;
+                        }
+                        snprintf(fmt, sizeof(fmt), "<%%%s%s%s%c>", flags, width, prec, convs[ci]);
+                        TEST_DIFF(fmt, (int)value);
+                        snprintf(fmt, sizeof(fmt), "<%%%s%s%shh%c>", flags, width, prec, convs[ci]);
+                        TEST_DIFF(fmt, (int)value);
+                        snprintf(fmt, sizeof(fmt), "<%%%s%s%sh%c>", flags, width, prec, convs[ci]);
+                        TEST_DIFF(fmt, (int)value);
+                        snprintf(fmt, sizeof(fmt), "<%%%s%s%sl%c>", flags, width, prec, convs[ci]);
+                        TEST_DIFF(fmt, (long)value * 1000003L);
+                        snprintf(fmt, sizeof(fmt), "<%%%s%s%sll%c>", flags, width, prec, convs[ci]);
+                        TEST_DIFF(fmt, value * 1000000007LL);
+                    }
+                }
+
+                if (test_has_flag(flags, '0') || test_has_flag(flags, '+') ||
+                    test_has_flag(flags, ' ') || test_has_flag(flags, '#'))
+                {
+                    continue;
+                }
+                snprintf(fmt, sizeof(fmt), "<%%%s%s%ss>", flags, width, prec);
+                TEST_DIFF(fmt, "hello world");
+                TEST_DIFF(fmt, "");
+                if (prec[0] == '\0')
+                {
+                    snprintf(fmt, sizeof(fmt), "<%%%s%sc>", flags, width);
+                    TEST_DIFF(fmt, 'Q');
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief 边界值、其他长度修饰、*宽度精度、指针和%%的对比
+ */
+static void test_misc(void)
+{
+    TEST_DIFF("%llu %llx %lld %lld", ULLONG_MAX, ULLONG_MAX, LLONG_MIN, LLONG_MAX);
+    TEST_DIFF("%lu %lx %ld %ld", ULONG_MAX, ULONG_MAX, LONG_MIN, LONG_MAX);
+    TEST_DIFF("%jd %ju %zu %td", (intmax_t)-5, (uintmax_t)7, (size_t)12345, (ptrdiff_t)-9);
+    TEST_DIFF("%*d|%-*d|%.*d|%*.*s|", 6, 1, 4, 2, 3, 5, 8, 2, "xyz");
+    TEST_DIFF("%*d|%.*d|%.*s|", -6, 1, -1, 5, -1, "abc");
+    TEST_DIFF("%p %p", (void*)0x1234, (void*)&test_count);
+    TEST_DIFF("100%% done %s", "ok");
+    TEST_DIFF("%#o %#x %#X %#.0o", 0u, 0u, 255u, 0u);
+}
+
+/**
+ * @brief C库行为不统一或本模块有意不同的情况，与期望值直接对比
+ */
+static void test_special(void)
+{
+    char buf[64];
+    int len;
+
+    /* 截断时返回完整长度，缓存以结束符结尾 */
+    len = letk_fmt_snprintf(buf, 8, "%s-%d", "abcdef", 12345);
+    test_check((len == 12) && (strcmp(buf, "abcdef-") == 0), __LINE__, "abcdef- 12", 12, buf, len);
+    test_count++;
+
+    /* 只计算长度 */
+    len = letk_fmt_snprintf(NULL, 0, "%d", 12345);
+    test_check(len == 5, __LINE__, "", 5, "", len);
+    test_count++;
+
+    /* NULL字符串，glibc同样输出(null)，newlib不保证 */
+    len = letk_fmt_snprintf(buf, sizeof(buf), "%s", (char*)NULL);
+    test_check((len == 6) && (strcmp(buf, "(null)") == 0), __LINE__, "(null)", 6, buf, len);
+    test_count++;
+
+    /* 浮点数读取参数后原样输出说明符 */
+    len = letk_fmt_snprintf(buf, sizeof(buf), "f=%f e=%.2e %d %Lf %s", 1.5, 2.5, 7, (long double)1.0, "x");
+    test_check(strcmp(buf, "f=%f e=%.2e 7 %Lf x") == 0, __LINE__, "f=%f e=%.2e 7 %Lf x", 19, buf, len);
+    test_count++;
+
+    /* 不认识的说明符原样输出且不读取参数 */
+    len = letk_fmt_snprintf(buf, sizeof(buf), "bad %q %d %", 5);
+    test_check(strcmp(buf, "bad %q 5 %") == 0, __LINE__, "bad %q 5 %", 10, buf, len);
+    test_count++;
+
+    /* 逐字符回调输出 */
+    test_cb_len = 0;
+    len = letk_fmt_printf_cb(test_putc, "cb %05d|%-4s|%x", -42, "ab", 0xbeef);
+    test_cb_buf[test_cb_len] = '\0';
+    test_check((len == 18) && (strcmp(test_cb_buf, "cb -0042|ab  |beef") == 0), __LINE__,
+               "cb -0042|ab  |beef", 18, test_cb_buf, len);
+    test_count++;
+}
+
+/**
+ * @brief 主函数
+ * @return 0：全部通过，1：有失败
+ */
+int main(void)
+{
+    test_matrix();
+    test_misc();
+    test_special();
+
+    printf("%lu checks, %lu failed\n", test_count, test_fails);
+    return (test_fails == 0) ? 0 : 1;
+}
@@ -0,0 +1,11 @@
+#!/bin/sh
+# 在主机上编译并运行轻量格式化输出的差分测试和基准测试
+# 用法：sh fmt/test/run.sh [基准测试每个场景的调用次数]，编译器由环境变量CC指定，默认cc
+set -e
+cd "$(dirname "$0")"
+CC=${CC:-cc}
+OUT=${TMPDIR:-/tmp}
+$CC -std=c99 -O2 -Wall -Wextra -I. -I.. ../letk_fmt.c letk_fmt_test.c -o "$OUT/letk_fmt_test"
+"$OUT/letk_fmt_test"
+$CC -std=c99 -O2 -Wall -Wextra -I. -I.. ../letk_fmt.c letk_fmt_bench.c -o "$OUT/letk_fmt_bench"
+"$OUT/letk_fmt_bench" "$@"
@@ -12,6 +12,7 @@
 ** 修改记录
 ** 修改日期         修改作者        修改内容
 ** 2022年7月5日     付瑞彪          创建文件，初次版本
+** 2026年10月18日   付瑞彪          日志改为模块日志，可在运行时修改等级
 **
 ***********************************************************************************************************************/
 
@@ -25,8 +26,9 @@
 
 /* 创建本模块的日志打印 */
 #if LETK_HEAP_LOG_ENABLE
-#define LETK_HEAP_LOG_DEBUG(...)    LETK_LOG(DEBUG, __VA_ARGS__)
-#define LETK_HEAP_LOG_ERROR(...)    LETK_LOG(ERROR, __VA_ARGS__)
+LETK_LOG_MODULE_DEFINE(HEAP)
+#define LETK_HEAP_LOG_DEBUG(...)    LETK_LOG_MODULE(HEAP, DEBUG, __VA_ARGS__)
+#define LETK_HEAP_LOG_ERROR(...)    LETK_LOG_MODULE(HEAP, ERROR, __VA_ARGS__)
 #else   /* LETK_HEAP_LOG_ENABLE */
 #define LETK_HEAP_LOG_DEBUG(...)
 #define LETK_HEAP_LOG_ERROR(...)
@@ -57,6 +59,9 @@ bool letk_heap_init(void)
     memset(letk_heap_flag_map, LETK_HEAP_FLAG_FREE, sizeof(letk_heap_flag_map));
     letk_heap_init_flag = true;
 
+#if LETK_HEAP_LOG_ENABLE
+    LETK_LOG_MODULE_REGISTER(HEAP);
+#endif  /* LETK_HEAP_LOG_ENABLE */
     LETK_HEAP_LOG_DEBUG("letk_heap_init ok");
 
     return true;
@@ -13,6 +13,18 @@
 ** 修改日期         修改作者        修改内容
 ** 2022年5月29日    付瑞彪          创建文件，初次版本
 ** 2022年7月15日    付瑞彪          修改代码注释规范
+** 2026年10月18日   付瑞彪          增加异步日志，调用者只记录参数，格式化和输出延后到刷新时进行
+** 2026年10月18日   付瑞彪          增加二进制日志，格式化字符串放入不加载的段，由主机工具解码
+** 2026年10月18日   付瑞彪          代码位置和等级前缀在编译期生成，输出时不再查找文件名和格式化前缀
+** 2026年10月18日   付瑞彪          增加可选的轻量格式化，不依赖stdio
+** 2026年10月18日   付瑞彪          增加模块日志，每个模块有独立的运行时日志等级
+** 2026年10月18日   付瑞彪          增加按调用点的限流和重复日志合并，在格式化之前判断
+** 2026年10月18日   付瑞彪          增加多输出目标，每个目标有独立的最低等级，按长度输出
+** 2026年10月18日   付瑞彪          增加多线程行提交模式，调用者在栈上格式化，整行原子提交
+** 2026年10月18日   付瑞彪          限流和重复提示使用被过滤调用点的代码位置，二进制日志中不带代码位置
+** 2026年10月18日   付瑞彪          重复合并比较等级和参数指纹，超过合并时间后重新输出
+** 2026年10月18日   付瑞彪          二进制编码的边界检查同时检查编码字节位置，消除越界写入告警
+** 2026年10月18日   付瑞彪          输出时去掉文件路径改为由LETK_LOG_FILE_PATH显式使能
 **
 ***********************************************************************************************************************/
 
@@ -23,12 +35,35 @@
 #include <stdarg.h>
 #include <string.h>
 #include <stddef.h>
+#if LETK_LOG_MODULE_ENABLE && LETK_LOG_MODULE_CLI_ENABLE
+#include "letk_cli.h"
+#endif  /* LETK_LOG_MODULE_ENABLE && LETK_LOG_MODULE_CLI_ENABLE */
+#if LETK_LOG_USE_FMT
+#include "letk_fmt.h"
+#endif  /* LETK_LOG_USE_FMT */
+#if LETK_LOG_USE_PRINTF || !LETK_LOG_USE_FMT
 #include <stdio.h>
+#endif  /* LETK_LOG_USE_PRINTF || !LETK_LOG_USE_FMT */
+#if ((LETK_LOG_ASYNC_SIZE > 0) && LETK_LOG_ASYNC_MPSC) || (LETK_LOG_RING_SIZE > 0)
+#include <stdatomic.h>
+#endif  /* ((LETK_LOG_ASYNC_SIZE > 0) && LETK_LOG_ASYNC_MPSC) || (LETK_LOG_RING_SIZE > 0) */
 
 #ifdef __cplusplus
 extern 'C' {
 #endif  /* __cplusplus */
 
+/* 格式化函数，使用轻量格式化时不依赖stdio */
+#if LETK_LOG_USE_FMT
+#define LETK_LOG_SNPRINTF       letk_fmt_snprintf
+#define LETK_LOG_VSNPRINTF      letk_fmt_vsnprintf
+#else   /* LETK_LOG_USE_FMT */
+#define LETK_LOG_SNPRINTF       snprintf
+#define LETK_LOG_VSNPRINTF      vsnprintf
+#endif  /* LETK_LOG_USE_FMT */
+
+/* 一行日志正文的最大长度，预留换行和结束符 */
+#define LETK_LOG_LINE_MAX       ((int)LETK_LOG_BUF_SIZE - 3)
+
 /* 日志前缀 */
 static const char* const log_prefix[] =
 {
@@ -37,25 +72,181 @@ static const char* const log_prefix[] =
     [LETK_LOG_LEVEL_WARNING] = "[W] ",
     [LETK_LOG_LEVEL_ERROR]   = "[E] ",
 };
-/* 日志的缓存，用于输出日志 */
+/* 日志的缓存，用于输出日志，异步模式下只在刷新时使用，行提交模式下只在输出时使用 */
 static char log_buf[LETK_LOG_BUF_SIZE];
 
+#if !LETK_LOG_USE_PRINTF
 /* 日志打印回调函数指针 */
 static letk_log_puts_cb_t* letk_log_puts_cb = NULL;
+#endif  /* !LETK_LOG_USE_PRINTF */
 /* 日志输出开始回调函数 */
 static letk_log_hook_cb_t* letk_log_start_cb = NULL;
 /* 日志输出结束回调函数 */
 static letk_log_hook_cb_t* letk_log_end_cb = NULL;
+/* 日志时间戳回调函数 */
+static letk_log_time_cb_t* letk_log_time_cb = NULL;
+
+#if LETK_LOG_MODULE_ENABLE
+/* 日志模块注册表 */
+static letk_log_module_t* p_log_module_head = NULL;
+#if LETK_LOG_MODULE_CLI_ENABLE
+/* 等级名称，与日志等级对应 */
+static const char* const log_level_name[] =
+{
+    [LETK_LOG_LEVEL_DEBUG]   = "DEBUG",
+    [LETK_LOG_LEVEL_INFO]    = "INFO",
+    [LETK_LOG_LEVEL_WARNING] = "WARNING",
+    [LETK_LOG_LEVEL_ERROR]   = "ERROR",
+    [LETK_LOG_LEVEL_NONE]    = "NONE",
+};
+#endif  /* LETK_LOG_MODULE_CLI_ENABLE */
+#endif  /* LETK_LOG_MODULE_ENABLE */
+
+#if LETK_LOG_RING_SIZE > 0
+/* 行提交环形缓存的字数 */
+#define LETK_LOG_RING_WORDS     (LETK_LOG_RING_SIZE / 4u)
+/* 记录头：位0已提交，位1填充，位2-7等级，位8-31长度(数据为字节数，填充为字数)，0表示未提交 */
+#define LETK_LOG_RING_COMMIT    0x01u
+#define LETK_LOG_RING_PAD       0x02u
+
+/* 行提交环形缓存，按字访问，空闲部分全部为0 */
+static atomic_uint_least32_t log_ring[LETK_LOG_RING_WORDS];
+/* 预留位置，单位：字，多个调用者竞争 */
+static atomic_uint log_ring_head;
+/* 读位置，单位：字，只由正在输出的调用者修改 */
+static atomic_uint log_ring_tail;
+/* 是否有调用者正在输出 */
+static atomic_flag log_ring_busy = ATOMIC_FLAG_INIT;
+/* 缓存满丢弃的日志条数 */
+static atomic_uint log_dropped;
+/* 已报告的丢弃条数 */
+static uint32_t log_dropped_reported = 0;
+#endif  /* LETK_LOG_RING_SIZE > 0 */
+
+#if LETK_LOG_SINK_ENABLE
+/* 日志输出目标注册表 */
+static letk_log_sink_t* p_log_sink_head = NULL;
+#endif  /* LETK_LOG_SINK_ENABLE */
+
+#if LETK_LOG_REPEAT_MAX > 0
+/* 上一条输出的日志的调用点和等级 */
+static const letk_log_site_t* p_log_repeat_site = NULL;
+static letk_log_level_t log_repeat_level = LETK_LOG_LEVEL_NONE;
+/* 上一条输出的日志的参数指纹和输出时间 */
+static uint32_t log_repeat_hash = 0;
+static uint32_t log_repeat_time = 0;
+/* 上一条日志之后被合并的条数 */
+static uint32_t log_repeat_count = 0;
+#endif  /* LETK_LOG_REPEAT_MAX > 0 */
+
+#if LETK_LOG_BINARY_ENABLE
+#if !LETK_LOG_USE_PRINTF
+/* 二进制日志数据输出回调函数 */
+static letk_log_write_cb_t* letk_log_write_cb = NULL;
+#endif  /* !LETK_LOG_USE_PRINTF */
+/* 二进制记录首字节中表示带时间戳的标志 */
+#define LETK_LOG_BIN_FLAG_TIME  0x08u
+/* COBS编码状态，当前块的编码字节位置和下一个写入位置 */
+static int log_bin_code = 0;
+static int log_bin_index = 0;
+#endif  /* LETK_LOG_BINARY_ENABLE */
+
+/* 是否需要解析格式说明符，异步日志记录参数和文本日志重复合并计算参数指纹时使用 */
+#define LETK_LOG_PARSE_ENABLE   ((LETK_LOG_ASYNC_SIZE > 0) || ((LETK_LOG_REPEAT_MAX > 0) && !LETK_LOG_BINARY_ENABLE))
+
+#if LETK_LOG_PARSE_ENABLE
+/* 格式说明符的长度修饰 */
+enum
+{
+    LETK_LOG_LEN_NONE,          /* 无 */
+    LETK_LOG_LEN_HH,            /* hh */
+    LETK_LOG_LEN_H,             /* h */
+    LETK_LOG_LEN_L,             /* l */
+    LETK_LOG_LEN_LL,            /* ll */
+    LETK_LOG_LEN_J,             /* j */
+    LETK_LOG_LEN_Z,             /* z */
+    LETK_LOG_LEN_T,             /* t */
+    LETK_LOG_LEN_BIG_L,         /* L */
+};
+
+/* 格式说明符 */
+typedef struct
+{
+    const char* start;          /* '%'的位置 */
+    const char* end;            /* 转换字符之后的位置 */
+    uint8_t stars;              /* 宽度和精度中'*'的个数 */
+    uint8_t length;             /* 长度修饰 */
+    char conv;                  /* 转换字符，0表示不支持的说明符 */
+} letk_log_spec_t;
+#endif  /* LETK_LOG_PARSE_ENABLE */
+
+#if LETK_LOG_ASYNC_SIZE > 0
+/* 记录的参数，整数统一按最大宽度保存，浮点统一按double保存 */
+typedef union
+{
+    uintmax_t i;                /* 整数和字符 */
+    double d;                   /* 浮点数 */
+    const void* p;              /* 字符串和指针 */
+} letk_log_arg_t;
+
+/* 日志条目的内容 */
+typedef struct
+{
+    const char* loc;            /* 代码位置 */
+    const char* func;           /* 函数名 */
+    const char* fmt;            /* 格式化字符串 */
+    uint32_t time;              /* 时间戳 */
+    letk_log_level_t level;     /* 日志等级 */
+    uint8_t argc;               /* 记录的参数个数 */
+    letk_log_arg_t args[LETK_LOG_ASYNC_ARGS];   /* 参数 */
+} letk_log_record_t;
+
+/* 条目队列掩码 */
+#define LETK_LOG_ASYNC_MASK     (LETK_LOG_ASYNC_SIZE - 1u)
+
+#if LETK_LOG_ASYNC_MPSC
+/* 日志条目，seq为序号相对条目下标的偏移，静态清零即为初始状态 */
+typedef struct
+{
+    atomic_uint seq;            /* 序号偏移，用于生产者之间和生产者与消费者之间同步 */
+    letk_log_record_t rec;      /* 日志内容 */
+} letk_log_entry_t;
+
+/* 日志条目队列 */
+static letk_log_entry_t log_queue[LETK_LOG_ASYNC_SIZE];
+/* 生产者写位置 */
+static atomic_uint log_head;
+/* 消费者读位置，只在letk_log_flush中访问 */
+static unsigned int log_tail = 0;
+/* 队列满丢弃的条目数 */
+static atomic_uint log_dropped;
+#else   /* LETK_LOG_ASYNC_MPSC */
+/* 日志条目队列，单生产者单消费者，生产者只写head，消费者只写tail，
+ * 必须加volatile关键字，保证条目写完之后才更新head */
+static volatile letk_log_record_t log_queue[LETK_LOG_ASYNC_SIZE];
+/* 生产者写位置 */
+static volatile uint32_t log_head = 0;
+/* 消费者读位置 */
+static volatile uint32_t log_tail = 0;
+/* 队列满丢弃的条目数 */
+static volatile uint32_t log_dropped = 0;
+#endif  /* LETK_LOG_ASYNC_MPSC */
+
+/* 上一次刷新时已报告的丢弃条目数 */
+static uint32_t log_dropped_reported = 0;
+#endif  /* LETK_LOG_ASYNC_SIZE > 0 */
 
 /**
  * @brief 日志系统初始化
  * @param[in] puts_cb 字符串输出回调函数
  * @param[in] end_cb 输出结束回调函数，不用可以置为NULL
  */
+#if !LETK_LOG_USE_PRINTF
 void letk_log_init(letk_log_puts_cb_t* puts_cb)
 {
     letk_log_puts_cb = puts_cb;
 }
+#endif  /* !LETK_LOG_USE_PRINTF */
 
 /**
  * @brief 设置日志系统钩子回调函数
@@ -69,71 +260,362 @@ void letk_log_set_hook_cb(letk_log_hook_cb_t* start_cb, letk_log_hook_cb_t* end_
 }
 
 /**
- * @brief 输出一条日志，此函数内部宏使用，用户不要直接使用
+ * @brief 设置日志时间戳回调函数
+ * @param[in] time_cb 时间戳回调函数，NULL表示不输出时间戳
+ */
+void letk_log_set_time_cb(letk_log_time_cb_t* time_cb)
+{
+    letk_log_time_cb = time_cb;
+}
+
+#if LETK_LOG_SINK_ENABLE
+/**
+ * @brief 注册日志输出目标，已注册的只更新回调函数和等级
+ * @param[in] ps 输出目标指针，由调用者分配，注销前必须一直有效
+ * @param[in] write_cb 数据输出回调函数
+ * @param[in] level 最低等级
+ */
+void letk_log_sink_register(letk_log_sink_t* ps, letk_log_write_cb_t* write_cb, letk_log_level_t level)
+{
+    const letk_log_sink_t* p = p_log_sink_head;
+
+    if ((ps == NULL) || (write_cb == NULL))
+    {
+        return;
+    }
+
+    ps->write_cb = write_cb;
+    ps->level = level;
+
+    /* 搜索是否已经存在于注册表中 */
+    while (p != NULL)
+    {
+        if (p == ps)
+        {
+            return;
+        }
+        p = p->next;
+    }
+
+    /* 添加到注册表头部 */
+    ps->next = p_log_sink_head;
+    p_log_sink_head = ps;
+}
+
+/**
+ * @brief 注销日志输出目标
+ * @param[in] ps 输出目标指针
+ */
+void letk_log_sink_unregister(letk_log_sink_t* ps)
+{
+    letk_log_sink_t** pp = &p_log_sink_head;
+
+    while (*pp != NULL)
+    {
+        if (*pp == ps)
+        {
+            /* 断链 */
+            *pp = ps->next;
+            ps->next = NULL;
+            return;
+        }
+        pp = &(*pp)->next;
+    }
+}
+
+#if !LETK_LOG_USE_PRINTF
+/**
+ * @brief 判断是否有输出目标需要此等级的日志
  * @param[in] level 日志等级
- * @param[in] file 当前代码路径
- * @param[in] line 当前代码行号
- * @param[in] func 当前代码函数名
- * @param[in] fmt 格式化字符串
- * @param[in] ... 可变参数，fmt中的格式排列
+ * @return 是否需要
  */
-void letk_log_output(letk_log_level_t level, const char* file, int line, const char* func, const char* fmt, ...)
+static bool letk_log_sink_wanted(letk_log_level_t level)
 {
-    int index, length, remain, posit;
-    va_list args;
+    const letk_log_sink_t* ps;
+
+    for (ps = p_log_sink_head; ps != NULL; ps = ps->next)
+    {
+        if (level >= ps->level)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+#endif  /* !LETK_LOG_USE_PRINTF */
+
+/**
+ * @brief 把一条已格式化的日志输出到所有需要此等级的目标
+ * @param[in] level 日志等级
+ * @param[in] buf 数据
+ * @param[in] len 数据长度
+ */
+static void letk_log_sink_write(letk_log_level_t level, const uint8_t* buf, uint32_t len)
+{
+    const letk_log_sink_t* ps;
+
+    for (ps = p_log_sink_head; ps != NULL; ps = ps->next)
+    {
+        if (level >= ps->level)
+        {
+            ps->write_cb(buf, len);
+        }
+    }
+}
+#endif  /* LETK_LOG_SINK_ENABLE */
+
+#if LETK_LOG_MODULE_ENABLE
+/**
+ * @brief 注册日志模块，已注册的不会重复添加
+ * @param[in] pm 日志模块指针
+ */
+void letk_log_module_register(letk_log_module_t* pm)
+{
+    const letk_log_module_t* p = p_log_module_head;
 
-    if (level >= LETK_LOG_LEVEL_NONE)
+    if (pm == NULL)
     {
         return;
     }
 
-    /* 日志开始钩子回调函数 */
-    if (letk_log_start_cb)
+    /* 搜索是否已经存在于注册表中 */
+    while (p != NULL)
     {
-        letk_log_start_cb();
+        if (p == pm)
+        {
+            return;
+        }
+        p = p->next;
+    }
+
+    /* 添加到注册表头部 */
+    pm->next = p_log_module_head;
+    p_log_module_head = pm;
+}
+
+/**
+ * @brief 遍历日志模块注册表
+ * @param[in] pm 当前日志模块指针，为NULL时返回第一个
+ * @return 下一个已注册的日志模块指针，NULL表示遍历结束
+ */
+letk_log_module_t* letk_log_module_next(const letk_log_module_t* pm)
+{
+    return (pm == NULL) ? p_log_module_head : pm->next;
+}
+
+/**
+ * @brief 按名称设置已注册日志模块的运行时等级
+ * @param[in] name 模块名，"all"表示全部模块
+ * @param[in] level 日志等级，LETK_LOG_LEVEL_NONE表示关闭
+ * @return 是否找到模块
+ */
+bool letk_log_module_set_level(const char* name, letk_log_level_t level)
+{
+    letk_log_module_t* pm;
+    bool all = (strcmp(name, "all") == 0);
+    bool found = false;
+
+    if ((level < LETK_LOG_LEVEL_DEBUG) || (level > LETK_LOG_LEVEL_NONE))
+    {
+        return false;
+    }
+
+    for (pm = p_log_module_head; pm != NULL; pm = pm->next)
+    {
+        if (all || (strcmp(pm->name, name) == 0))
+        {
+            pm->level = level;
+            found = true;
+        }
+    }
+    return found;
+}
+
+#if LETK_LOG_MODULE_CLI_ENABLE
+/* 按名称或数字解析日志等级，不区分大小写，失败返回-1 */
+static letk_log_level_t letk_log_parse_level(const char* str)
+{
+    letk_log_level_t level;
+    const char* p;
+    const char* q;
+
+    if ((str[0] >= '0') && (str[0] <= '0' + LETK_LOG_LEVEL_NONE) && (str[1] == '\0'))
+    {
+        return (letk_log_level_t)(str[0] - '0');
+    }
+    for (level = LETK_LOG_LEVEL_DEBUG; level <= LETK_LOG_LEVEL_NONE; level++)
+    {
+        for (p = str, q = log_level_name[level]; (*p != '\0') && ((*p & ~0x20) == *q); p++, q++)
+        {
+        }
+        if ((*p == '\0') && (*q == '\0'))
+        {
+            return level;
+        }
+    }
+    return -1;
+}
+
+/* 命令-log，不带参数时列出全部模块的日志等级，log level <module|all> <level>修改等级 */
+void letk_log_cli_cmd(int argc, char* argv[])
+{
+    const letk_log_module_t* pm;
+    letk_log_level_t level;
+
+    if ((argc == 4) && (strcmp(argv[1], "level") == 0))
+    {
+        level = letk_log_parse_level(argv[3]);
+        if (level < 0)
+        {
+            letk_cli_put_str("    invalid level, use DEBUG/INFO/WARNING/ERROR/NONE\r\n");
+        }
+        else if (!letk_log_module_set_level(argv[2], level))
+        {
+            letk_cli_put_str("    module not found\r\n");
+        }
+        return;
+    }
+    if ((argc > 2) || ((argc == 2) && (strcmp(argv[1], "level") != 0)))
+    {
+        letk_cli_put_str("    usage: log [level <module|all> <level>]\r\n");
+        return;
+    }
+
+    for (pm = p_log_module_head; pm != NULL; pm = pm->next)
+    {
+        letk_cli_put_str("    ");
+        letk_cli_put_str(pm->name);
+        letk_cli_put_str(": ");
+        letk_cli_put_str(log_level_name[pm->level]);
+        letk_cli_put_str("\r\n");
+    }
+}
+/* 导出log命令 */
+LETK_CLI_CMD_EXPORT(log,
+                  "log [level <module|all> <level>] -- list or set the runtime level of log modules",
+                  letk_log_cli_cmd);
+#endif  /* LETK_LOG_MODULE_CLI_ENABLE */
+#endif  /* LETK_LOG_MODULE_ENABLE */
+
+/**
+ * @brief 根据格式化函数的返回值推进写位置，超出缓存时截断
+ * @param[in] index 当前写位置
+ * @param[in] length 格式化函数的返回值
+ * @return 新的写位置
+ */
+static int letk_log_advance(int index, int length)
+{
+    if (length > 0)
+    {
+        index += length;
+    }
+    return (index < LETK_LOG_LINE_MAX) ? index : LETK_LOG_LINE_MAX;
+}
+
+/**
+ * @brief 复制字符串到缓存，超出缓存时截断
+ * @param[out] buf 缓存，大小为LETK_LOG_BUF_SIZE
+ * @param[in] index 当前写位置
+ * @param[in] str 字符串
+ * @return 新的写位置
+ */
+static int letk_log_put_str(char* buf, int index, const char* str)
+{
+    while ((*str != '\0') && (index < LETK_LOG_LINE_MAX))
+    {
+        buf[index++] = *str++;
     }
+    return index;
+}
 
-    /* 初始化参数 */
-    index = 0;
-    remain = sizeof(log_buf) - 1;
+/**
+ * @brief 输出日志头，包括等级前缀、时间戳和代码位置
+ * @param[out] buf 缓存，大小为LETK_LOG_BUF_SIZE
+ * @param[in] level 日志等级
+ * @param[in] time 时间戳
+ * @param[in] loc 代码位置，编译期生成的"[文件名:行号 "
+ * @param[in] func 当前代码函数名
+ * @return 写位置
+ */
+static int letk_log_put_head(char* buf, letk_log_level_t level, uint32_t time, const char* loc, const char* func)
+{
+    char digits[10];
+    int index, count = 0;
+#if LETK_LOG_FILE_PATH
+    const char* p;
+#endif  /* LETK_LOG_FILE_PATH */
 
     /* 输出前缀 */
-    length = snprintf(&log_buf[index], remain, log_prefix[level]);
-    index += length;
-    remain -= length;
+    index = letk_log_put_str(buf, 0, log_prefix[level]);
 
-    /* 寻找文件名，忽略路径 */
-    length = strlen(file);
-    for (posit = length; posit > 0; posit--)
+    /* 输出时间戳 */
+    if (letk_log_time_cb)
     {
-        if ((file[posit] == '/') || (file[posit] == '\\'))
+        do
         {
-            posit++;
-            break;
+            digits[count++] = (char)('0' + time % 10u);
+            time /= 10u;
+        } while (time > 0);
+        index = letk_log_put_str(buf, index, "[");
+        while ((count > 0) && (index < LETK_LOG_LINE_MAX))
+        {
+            buf[index++] = digits[--count];
         }
+        index = letk_log_put_str(buf, index, "] ");
     }
 
-    /* 输出文件信息 */
-    length = snprintf(&log_buf[index], remain, "[%s:%d %s] ", &file[posit], line, func);
-    index += length;
-    remain -= length;
+#if LETK_LOG_FILE_PATH
+    /* 显式使能时去掉路径，每条日志都要扫描一遍位置，位置中只有路径部分会出现分隔符 */
+    for (p = loc; *p != '\0'; p++)
+    {
+        if ((*p == '/') || (*p == '\\'))
+        {
+            loc = p;
+        }
+    }
+    if (*loc != '[')
+    {
+        index = letk_log_put_str(buf, index, "[");
+        loc++;
+    }
+#endif  /* LETK_LOG_FILE_PATH */
 
-    /* 输出打印内容 */
-    va_start(args, fmt);
-    length = vsnprintf(&log_buf[index], remain, fmt, args);
-    va_end(args);
-    index += length;
-    remain -= length;
+    /* 输出代码位置 */
+    index = letk_log_put_str(buf, index, loc);
+    index = letk_log_put_str(buf, index, func);
+    return letk_log_put_str(buf, index, "] ");
+}
 
-    /* 输出换行 */
-    snprintf(&log_buf[index], remain, "\r\n");
+/**
+ * @brief 补充换行和结束符
+ * @param[out] buf 缓存，大小为LETK_LOG_BUF_SIZE
+ * @param[in] index 写位置
+ * @return 一行的长度，包括换行不包括结束符
+ */
+static int letk_log_end_line(char* buf, int index)
+{
+    buf[index++] = '\r';
+    buf[index++] = '\n';
+    buf[index] = '\0';
+    return index;
+}
 
-    /* 最后一字节补充0，防止结束符异常 */
-    log_buf[sizeof(log_buf) - 1] = '\0';
+/**
+ * @brief 输出缓存中已补充换行的一行日志
+ * @param[in] level 日志等级
+ * @param[in] index 一行的长度，包括换行不包括结束符
+ */
+static void letk_log_put_out(letk_log_level_t level, int index)
+{
+    /* 日志开始钩子回调函数 */
+    if (letk_log_start_cb)
+    {
+        letk_log_start_cb();
+    }
 
 #if LETK_LOG_USE_PRINTF
     /* 打印 */
-    printf((const char*)log_buf);
+    printf("%s", log_buf);
 #else   /* LETK_LOG_USE_PRINTF */
     /* 自定义打印 */
     if (letk_log_puts_cb)
@@ -142,6 +624,14 @@ void letk_log_output(letk_log_level_t level, const char* file, int line, const c
     }
 #endif  /* LETK_LOG_USE_PRINTF */
 
+#if LETK_LOG_SINK_ENABLE
+    /* 输出到各个目标，长度已知，不需要再计算 */
+    letk_log_sink_write(level, (const uint8_t*)log_buf, (uint32_t)index);
+#else   /* LETK_LOG_SINK_ENABLE */
+    (void)level;
+    (void)index;
+#endif  /* LETK_LOG_SINK_ENABLE */
+
     /* 接收调用钩子回调函数 */
     if (letk_log_end_cb)
     {
@@ -149,6 +639,1287 @@ void letk_log_output(letk_log_level_t level, const char* file, int line, const c
     }
 }
 
+/**
+ * @brief 补充换行并输出缓存中的一行日志
+ * @param[in] level 日志等级
+ * @param[in] index 写位置
+ */
+static void letk_log_put_line(letk_log_level_t level, int index)
+{
+    letk_log_put_out(level, letk_log_end_line(log_buf, index));
+}
+
+#if LETK_LOG_RING_SIZE > 0
+/**
+ * @brief 把一行日志放入行提交缓存，多个调用者无锁，只有一次原子预留
+ * @param[in] level 日志等级
+ * @param[in] buf 一行日志，包括换行
+ * @param[in] len 长度
+ * @return 是否成功，缓存满时返回false
+ */
+static bool letk_log_ring_push(letk_log_level_t level, const char* buf, int len)
+{
+    unsigned int head, tail, offset, words, need, i, j;
+    uint_least32_t word;
+
+    words = 1u + ((unsigned int)len + 3u) / 4u;
+    head = atomic_load_explicit(&log_ring_head, memory_order_relaxed);
+    do
+    {
+        tail = atomic_load_explicit(&log_ring_tail, memory_order_acquire);
+        offset = head % LETK_LOG_RING_WORDS;
+        /* 记录不跨越缓存末尾，放不下时填充到末尾，从头开始 */
+        need = (offset + words > LETK_LOG_RING_WORDS) ? (LETK_LOG_RING_WORDS - offset + words) : words;
+        if (head + need - tail > LETK_LOG_RING_WORDS)
+        {
+            atomic_fetch_add_explicit(&log_dropped, 1u, memory_order_relaxed);
+            return false;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&log_ring_head, &head, head + need,
+                                                    memory_order_relaxed, memory_order_relaxed));
+
+    if (need != words)
+    {
+        atomic_store_explicit(&log_ring[offset],
+                              ((uint_least32_t)(LETK_LOG_RING_WORDS - offset) << 8) |
+                              LETK_LOG_RING_PAD | LETK_LOG_RING_COMMIT,
+                              memory_order_release);
+        offset = 0;
+    }
+
+    /* 按字复制，空闲部分由输出者清零 */
+    for (i = 0; i < (unsigned int)len; i += 4u)
+    {
+        word = 0;
+        for (j = 0; (j < 4u) && (i + j < (unsigned int)len); j++)
+        {
+            word |= (uint_least32_t)(uint8_t)buf[i + j] << (8u * j);
+        }
+        atomic_store_explicit(&log_ring[offset + 1u + i / 4u], word, memory_order_relaxed);
+    }
+
+    /* 提交，与输出者的检查构成全序，保证不会遗漏 */
+    atomic_store(&log_ring[offset], ((uint_least32_t)len << 8) | ((uint_least32_t)level << 2) | LETK_LOG_RING_COMMIT);
+    return true;
+}
+
+/**
+ * @brief 取出一行日志到log_buf，只由正在输出的调用者调用
+ * @param[out] plevel 日志等级
+ * @return 一行的长度，-1表示缓存为空或下一行还未提交
+ */
+static int letk_log_ring_pop(letk_log_level_t* plevel)
+{
+    unsigned int tail = atomic_load_explicit(&log_ring_tail, memory_order_relaxed);
+    unsigned int offset, words, i, j;
+    uint_least32_t head_word, word;
+    int len;
+
+    for (;;)
+    {
+        offset = tail % LETK_LOG_RING_WORDS;
+        head_word = atomic_load(&log_ring[offset]);
+        if ((head_word & LETK_LOG_RING_COMMIT) == 0)
+        {
+            return -1;
+        }
+        if ((head_word & LETK_LOG_RING_PAD) == 0)
+        {
+            break;
+        }
+        /* 跳过填充 */
+        atomic_store_explicit(&log_ring[offset], 0u, memory_order_relaxed);
+        tail += (unsigned int)(head_word >> 8);
+        atomic_store_explicit(&log_ring_tail, tail, memory_order_release);
+    }
+
+    len = (int)(head_word >> 8);
+    words = 1u + ((unsigned int)len + 3u) / 4u;
+    for (i = 1; i < words; i++)
+    {
+        word = atomic_load_explicit(&log_ring[offset + i], memory_order_relaxed);
+        atomic_store_explicit(&log_ring[offset + i], 0u, memory_order_relaxed);
+        for (j = 0; (j < 4u) && ((i - 1u) * 4u + j < (unsigned int)len); j++)
+        {
+            log_buf[(i - 1u) * 4u + j] = (char)(word >> (8u * j));
+        }
+    }
+    log_buf[len] = '\0';
+    *plevel = (letk_log_level_t)((head_word >> 2) & 0x3Fu);
+
+    /* 清零记录头后释放空间给调用者 */
+    atomic_store_explicit(&log_ring[offset], 0u, memory_order_relaxed);
+    atomic_store_explicit(&log_ring_tail, tail + words, memory_order_release);
+    return len;
+}
+
+/**
+ * @brief 下一行是否已提交
+ * @return 是否已提交
+ */
+static bool letk_log_ring_ready(void)
+{
+    unsigned int tail = atomic_load(&log_ring_tail);
+
+    return (atomic_load(&log_ring[tail % LETK_LOG_RING_WORDS]) & LETK_LOG_RING_COMMIT) != 0;
+}
+
+/**
+ * @brief 输出行提交缓存中已提交的日志，同一时刻只有一个调用者输出，其他调用者不等待
+ */
+static void letk_log_ring_drain(void)
+{
+    letk_log_level_t level;
+    uint32_t dropped;
+    int len;
+
+    do
+    {
+        /* 其他调用者正在输出时直接返回，由它输出本行 */
+        if (atomic_flag_test_and_set(&log_ring_busy))
+        {
+            return;
+        }
+
+        while ((len = letk_log_ring_pop(&level)) >= 0)
+        {
+            letk_log_put_out(level, len);
+        }
+
+        /* 报告上次输出以来丢弃的日志 */
+        dropped = atomic_load_explicit(&log_dropped, memory_order_relaxed);
+        if (dropped != log_dropped_reported)
+        {
+            len = letk_log_advance(0, LETK_LOG_SNPRINTF(log_buf, LETK_LOG_LINE_MAX + 1, "%s%lu log lines dropped",
+                                                        log_prefix[LETK_LOG_LEVEL_WARNING],
+                                                        (unsigned long)(dropped - log_dropped_reported)));
+            log_dropped_reported = dropped;
+            letk_log_put_line(LETK_LOG_LEVEL_WARNING, len);
+        }
+
+        atomic_flag_clear(&log_ring_busy);
+        /* 释放之前其他调用者提交的行可能没有被取出 */
+    } while (letk_log_ring_ready());
+}
+
+/**
+ * @brief 获取缓存满而丢弃的日志条数
+ * @return 累计丢弃的日志条数
+ */
+uint32_t letk_log_get_dropped(void)
+{
+    return atomic_load_explicit(&log_dropped, memory_order_relaxed);
+}
+#endif  /* LETK_LOG_RING_SIZE > 0 */
+
+#if LETK_LOG_PARSE_ENABLE
+/**
+ * @brief 解析一个格式说明符
+ * @param[in] p '%'的位置
+ * @param[out] ps 解析结果
+ * @note 只识别说明符的结构，不做任何转换，调用者上下文中记录参数时也使用
+ */
+static void letk_log_parse_spec(const char* p, letk_log_spec_t* ps)
+{
+    ps->start = p++;
+    ps->stars = 0;
+    ps->length = LETK_LOG_LEN_NONE;
+
+    /* 标志 */
+    while ((*p == '-') || (*p == '+') || (*p == ' ') || (*p == '#') || (*p == '0'))
+    {
+        p++;
+    }
+    /* 宽度 */
+    if (*p == '*')
+    {
+        ps->stars++;
+        p++;
+    }
+    while ((*p >= '0') && (*p <= '9'))
+    {
+        p++;
+    }
+    /* 精度 */
+    if (*p == '.')
+    {
+        p++;
+        if (*p == '*')
+        {
+            ps->stars++;
+            p++;
+        }
+        while ((*p >= '0') && (*p <= '9'))
+        {
+            p++;
+        }
+    }
+    /* 长度修饰 */
+    switch (*p)
+    {
+    case 'h':
+        p++;
+        ps->length = LETK_LOG_LEN_H;
+        if (*p == 'h')
+        {
+            p++;
+            ps->length = LETK_LOG_LEN_HH;
+        }
+        break;
+    case 'l':
+        p++;
+        ps->length = LETK_LOG_LEN_L;
+        if (*p == 'l')
+        {
+            p++;
+            ps->length = LETK_LOG_LEN_LL;
+        }
+        break;
+    case 'j': p++; ps->length = LETK_LOG_LEN_J; break;
+    case 'z': p++; ps->length = LETK_LOG_LEN_Z; break;
+    case 't': p++; ps->length = LETK_LOG_LEN_T; break;
+    case 'L': p++; ps->length = LETK_LOG_LEN_BIG_L; break;
+    default: break;
+    }
+    /* 转换字符 */
+    ps->conv = (*p != '\0') && (strchr("diuoxXcsfFeEgGaApn%", *p) != NULL) ? *p : 0;
+    ps->end = (ps->conv != 0) ? (p + 1) : p;
+}
+
+/**
+ * @brief 按说明符从可变参数中取出一个有符号整数
+ * @param[in] length 长度修饰
+ * @param[in] pargs 可变参数
+ * @return 整数值
+ */
+static intmax_t letk_log_arg_signed(uint8_t length, va_list* pargs)
+{
+    switch (length)
+    {
+    case LETK_LOG_LEN_L:  return va_arg(*pargs, long);
+    case LETK_LOG_LEN_LL: return va_arg(*pargs, long long);
+    case LETK_LOG_LEN_J:  return va_arg(*pargs, intmax_t);
+    case LETK_LOG_LEN_Z:  return (intmax_t)va_arg(*pargs, size_t);
+    case LETK_LOG_LEN_T:  return va_arg(*pargs, ptrdiff_t);
+    default:              return va_arg(*pargs, int);
+    }
+}
+
+/**
+ * @brief 按说明符从可变参数中取出一个无符号整数
+ * @param[in] length 长度修饰
+ * @param[in] pargs 可变参数
+ * @return 整数值
+ */
+static uintmax_t letk_log_arg_unsigned(uint8_t length, va_list* pargs)
+{
+    switch (length)
+    {
+    case LETK_LOG_LEN_L:  return va_arg(*pargs, unsigned long);
+    case LETK_LOG_LEN_LL: return va_arg(*pargs, unsigned long long);
+    case LETK_LOG_LEN_J:  return va_arg(*pargs, uintmax_t);
+    case LETK_LOG_LEN_Z:  return va_arg(*pargs, size_t);
+    case LETK_LOG_LEN_T:  return (uintmax_t)va_arg(*pargs, ptrdiff_t);
+    default:              return va_arg(*pargs, unsigned int);
+    }
+}
+#endif  /* LETK_LOG_PARSE_ENABLE */
+
+#if LETK_LOG_ASYNC_SIZE > 0
+/**
+ * @brief 按格式化字符串记录参数，不做任何转换
+ * @param[out] prec 日志内容，fmt必须已设置
+ * @param[in] pargs 可变参数
+ * @note 参数个数超过LETK_LOG_ASYNC_ARGS时，多出的说明符在输出时原样打印
+ */
+static void letk_log_capture(letk_log_record_t* prec, va_list* pargs)
+{
+    const char* p = prec->fmt;
+    letk_log_spec_t spec;
+    letk_log_arg_t* pa = prec->args;
+    uint8_t i;
+
+    prec->argc = 0;
+    while ((p = strchr(p, '%')) != NULL)
+    {
+        letk_log_parse_spec(p, &spec);
+        p = spec.end;
+        if (spec.conv == '%')
+        {
+            continue;
+        }
+        if ((spec.conv == 0) || ((uint32_t)prec->argc + spec.stars + 1u > LETK_LOG_ASYNC_ARGS))
+        {
+            /* 无法确定后续参数的类型或没有空间，停止记录 */
+            break;
+        }
+        for (i = 0; i < spec.stars; i++)
+        {
+            pa[prec->argc++].i = (uintmax_t)(intmax_t)va_arg(*pargs, int);
+        }
+        switch (spec.conv)
+        {
+        case 'd':
+        case 'i':
+            pa[prec->argc].i = (uintmax_t)letk_log_arg_signed(spec.length, pargs);
+            break;
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+            pa[prec->argc].i = letk_log_arg_unsigned(spec.length, pargs);
+            break;
+        case 'c':
+            pa[prec->argc].i = (uintmax_t)va_arg(*pargs, int);
+            break;
+        case 's':
+        case 'p':
+        case 'n':
+            pa[prec->argc].p = va_arg(*pargs, const void*);
+            break;
+        default:
+            pa[prec->argc].d = (spec.length == LETK_LOG_LEN_BIG_L) ?
+                               (double)va_arg(*pargs, long double) : va_arg(*pargs, double);
+            break;
+        }
+        prec->argc++;
+    }
+}
+
+/**
+ * @brief 按记录的参数格式化一个说明符
+ * @param[in] index 写位置
+ * @param[in] ps 说明符
+ * @param[in] pa 记录的参数，'*'的值在前
+ * @return 格式化函数的返回值
+ */
+static int letk_log_format_spec(int index, const letk_log_spec_t* ps, const letk_log_arg_t* pa)
+{
+    char spec[40];
+    const char* p;
+    int n = 0;
+    int star;
+    size_t size = (size_t)(LETK_LOG_LINE_MAX + 1 - index);
+    char* out = &log_buf[index];
+
+    /* 复制说明符，'*'替换为记录的数值，负精度视为未指定，浮点数已转为double，去掉L修饰 */
+    for (p = ps->start; (p < ps->end) && (n < (int)sizeof(spec) - 12); p++)
+    {
+        if (*p == '*')
+        {
+            star = (int)(intmax_t)(pa++)->i;
+            if ((p[-1] == '.') && (star < 0))
+            {
+                n--;
+                continue;
+            }
+            n += LETK_LOG_SNPRINTF(&spec[n], sizeof(spec) - (size_t)n, "%d", star);
+        }
+        else if (*p != 'L')
+        {
+            spec[n++] = *p;
+        }
+    }
+    spec[n] = '\0';
+    if (p < ps->end)
+    {
+        /* 说明符过长，原样输出 */
+        return LETK_LOG_SNPRINTF(out, size, "%.*s", (int)(ps->end - ps->start), ps->start);
+    }
+
+    switch (ps->conv)
+    {
+    case 'd':
+    case 'i':
+        switch (ps->length)
+        {
+        case LETK_LOG_LEN_L:  return LETK_LOG_SNPRINTF(out, size, spec, (long)(intmax_t)pa->i);
+        case LETK_LOG_LEN_LL: return LETK_LOG_SNPRINTF(out, size, spec, (long long)(intmax_t)pa->i);
+        case LETK_LOG_LEN_J:  return LETK_LOG_SNPRINTF(out, size, spec, (intmax_t)pa->i);
+        case LETK_LOG_LEN_Z:  return LETK_LOG_SNPRINTF(out, size, spec, (size_t)pa->i);
+        case LETK_LOG_LEN_T:  return LETK_LOG_SNPRINTF(out, size, spec, (ptrdiff_t)(intmax_t)pa->i);
+        default:              return LETK_LOG_SNPRINTF(out, size, spec, (int)(intmax_t)pa->i);
+        }
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+        switch (ps->length)
+        {
+        case LETK_LOG_LEN_L:  return LETK_LOG_SNPRINTF(out, size, spec, (unsigned long)pa->i);
+        case LETK_LOG_LEN_LL: return LETK_LOG_SNPRINTF(out, size, spec, (unsigned long long)pa->i);
+        case LETK_LOG_LEN_J:  return LETK_LOG_SNPRINTF(out, size, spec, pa->i);
+        case LETK_LOG_LEN_Z:  return LETK_LOG_SNPRINTF(out, size, spec, (size_t)pa->i);
+        case LETK_LOG_LEN_T:  return LETK_LOG_SNPRINTF(out, size, spec, (ptrdiff_t)pa->i);
+        default:              return LETK_LOG_SNPRINTF(out, size, spec, (unsigned int)pa->i);
+        }
+    case 'c':
+        return LETK_LOG_SNPRINTF(out, size, spec, (int)pa->i);
+    case 's':
+        return LETK_LOG_SNPRINTF(out, size, spec, (const char*)pa->p);
+    case 'p':
+        return LETK_LOG_SNPRINTF(out, size, spec, pa->p);
+    case 'n':
+        /* 不支持回写 */
+        return 0;
+    default:
+        return LETK_LOG_SNPRINTF(out, size, spec, pa->d);
+    }
+}
+
+/**
+ * @brief 格式化并输出一条记录的日志
+ * @param[in] prec 日志内容
+ */
+static void letk_log_put_record(const letk_log_record_t* prec)
+{
+    const char* p = prec->fmt;
+    const char* pnext;
+    letk_log_spec_t spec;
+    uint8_t argi = 0;
+    int index, length;
+
+    index = letk_log_put_head(log_buf, prec->level, prec->time, prec->loc, prec->func);
+
+    while ((*p != '\0') && (index < LETK_LOG_LINE_MAX))
+    {
+        /* 原样复制普通字符 */
+        pnext = strchr(p, '%');
+        length = (pnext != NULL) ? (int)(pnext - p) : (int)strlen(p);
+        if (length > LETK_LOG_LINE_MAX - index)
+        {
+            length = LETK_LOG_LINE_MAX - index;
+        }
+        memcpy(&log_buf[index], p, (size_t)length);
+        index += length;
+        if (pnext == NULL)
+        {
+            break;
+        }
+
+        letk_log_parse_spec(pnext, &spec);
+        p = spec.end;
+        if (spec.conv == '%')
+        {
+            log_buf[index++] = '%';
+        }
+        else if ((spec.conv != 0) && ((uint32_t)argi + spec.stars + 1u <= prec->argc))
+        {
+            index = letk_log_advance(index, letk_log_format_spec(index, &spec, &prec->args[argi]));
+            argi += spec.stars + 1u;
+        }
+        else
+        {
+            /* 没有记录参数的说明符原样输出 */
+            length = (int)(spec.end - spec.start);
+            if (length > LETK_LOG_LINE_MAX - index)
+            {
+                length = LETK_LOG_LINE_MAX - index;
+            }
+            memcpy(&log_buf[index], spec.start, (size_t)length);
+            index += length;
+            argi = prec->argc;
+        }
+    }
+
+    letk_log_put_line(prec->level, index);
+}
+
+#if LETK_LOG_ASYNC_MPSC
+/**
+ * @brief 放入一条日志，多生产者无锁
+ * @param[in] prec 日志内容
+ * @return 是否成功，队列满时返回false
+ */
+static bool letk_log_push(const letk_log_record_t* prec)
+{
+    unsigned int pos, index;
+    int diff;
+    letk_log_entry_t* pe;
+
+    pos = atomic_load_explicit(&log_head, memory_order_relaxed);
+    for (;;)
+    {
+        index = pos & LETK_LOG_ASYNC_MASK;
+        pe = &log_queue[index];
+        diff = (int)(index + atomic_load_explicit(&pe->seq, memory_order_acquire) - pos);
+        if (diff == 0)
+        {
+            /* 条目空闲，抢占写位置 */
+            if (atomic_compare_exchange_weak_explicit(&log_head, &pos, pos + 1u,
+                                                      memory_order_relaxed, memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            /* 队列已满 */
+            atomic_fetch_add_explicit(&log_dropped, 1u, memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            /* 被其他生产者抢先，重新读取写位置 */
+            pos = atomic_load_explicit(&log_head, memory_order_relaxed);
+        }
+    }
+
+    pe->rec = *prec;
+    /* 发布条目 */
+    atomic_store_explicit(&pe->seq, pos + 1u - index, memory_order_release);
+    return true;
+}
+
+/**
+ * @brief 取出一条日志，只在letk_log_flush中调用
+ * @param[out] prec 日志内容
+ * @return 是否取到，队列为空或生产者还未写完时返回false
+ */
+static bool letk_log_pop(letk_log_record_t* prec)
+{
+    unsigned int index = log_tail & LETK_LOG_ASYNC_MASK;
+    letk_log_entry_t* pe = &log_queue[index];
+
+    if ((index + atomic_load_explicit(&pe->seq, memory_order_acquire)) != (log_tail + 1u))
+    {
+        return false;
+    }
+
+    *prec = pe->rec;
+    /* 释放条目给下一轮的生产者 */
+    atomic_store_explicit(&pe->seq, log_tail + LETK_LOG_ASYNC_SIZE - index, memory_order_release);
+    log_tail++;
+    return true;
+}
+
+/**
+ * @brief 获取丢弃的日志条数
+ * @return 丢弃的日志条数
+ */
+uint32_t letk_log_get_dropped(void)
+{
+    return atomic_load_explicit(&log_dropped, memory_order_relaxed);
+}
+#else   /* LETK_LOG_ASYNC_MPSC */
+/**
+ * @brief 放入一条日志，单生产者无锁
+ * @param[in] prec 日志内容
+ * @return 是否成功，队列满时返回false
+ */
+static bool letk_log_push(const letk_log_record_t* prec)
+{
+    uint32_t head = log_head;
+
+    if ((head - log_tail) >= LETK_LOG_ASYNC_SIZE)
+    {
+        log_dropped++;
+        return false;
+    }
+
+    log_queue[head & LETK_LOG_ASYNC_MASK] = *prec;
+    /* 发布条目 */
+    log_head = head + 1u;
+    return true;
+}
+
+/**
+ * @brief 取出一条日志，只在letk_log_flush中调用
+ * @param[out] prec 日志内容
+ * @return 是否取到
+ */
+static bool letk_log_pop(letk_log_record_t* prec)
+{
+    uint32_t tail = log_tail;
+
+    if (tail == log_head)
+    {
+        return false;
+    }
+
+    *prec = log_queue[tail & LETK_LOG_ASYNC_MASK];
+    /* 释放条目 */
+    log_tail = tail + 1u;
+    return true;
+}
+
+/**
+ * @brief 获取丢弃的日志条数
+ * @return 丢弃的日志条数
+ */
+uint32_t letk_log_get_dropped(void)
+{
+    return log_dropped;
+}
+#endif  /* LETK_LOG_ASYNC_MPSC */
+
+/**
+ * @brief 格式化并输出队列中的全部日志
+ * @return 输出的日志条数
+ */
+uint32_t letk_log_flush(void)
+{
+    letk_log_record_t rec;
+    uint32_t count = 0;
+    uint32_t dropped;
+    int index;
+
+    /* 先取出再格式化，尽早释放条目给生产者 */
+    while (letk_log_pop(&rec))
+    {
+        letk_log_put_record(&rec);
+        count++;
+    }
+
+    /* 报告上次刷新以来丢弃的日志 */
+    dropped = letk_log_get_dropped();
+    if (dropped != log_dropped_reported)
+    {
+        index = letk_log_advance(0, LETK_LOG_SNPRINTF(log_buf, LETK_LOG_LINE_MAX + 1, "%s%lu log entries dropped",
+                                                      log_prefix[LETK_LOG_LEVEL_WARNING],
+                                                      (unsigned long)(dropped - log_dropped_reported)));
+        log_dropped_reported = dropped;
+        letk_log_put_line(LETK_LOG_LEVEL_WARNING, index);
+    }
+
+    return count;
+}
+#endif  /* LETK_LOG_ASYNC_SIZE > 0 */
+
+#if LETK_LOG_BINARY_ENABLE
+/**
+ * @brief 设置二进制日志的数据输出回调函数
+ * @param[in] write_cb 数据输出回调函数
+ */
+void letk_log_set_write_cb(letk_log_write_cb_t* write_cb)
+{
+#if LETK_LOG_USE_PRINTF
+    (void)write_cb;
+#else   /* LETK_LOG_USE_PRINTF */
+    letk_log_write_cb = write_cb;
+#endif  /* LETK_LOG_USE_PRINTF */
+}
+
+/**
+ * @brief 以COBS编码写入一个字节，编码后数据中不含0，0作为记录分隔符
+ * @param[in] byte 字节
+ * @return 是否成功，缓存满时返回false
+ */
+static bool letk_log_bin_byte(uint8_t byte)
+{
+    /* 预留本字节、可能新开块的编码字节和分隔符，
+     * 编码字节总在写入位置之前，一并检查使编译器能确认下面的写入都不越界 */
+    if ((log_bin_code < 0) || (log_bin_code >= log_bin_index) ||
+        (log_bin_index + 3 > (int)sizeof(log_buf)))
+    {
+        return false;
+    }
+
+    if (byte == 0)
+    {
+        /* 结束当前块，回填编码字节 */
+        log_buf[log_bin_code] = (char)(log_bin_index - log_bin_code);
+        log_bin_code = log_bin_index++;
+    }
+    else
+    {
+        log_buf[log_bin_index++] = (char)byte;
+        if ((log_bin_index - log_bin_code) == 0xFF)
+        {
+            /* 块满254个字节，不隐含0 */
+            log_buf[log_bin_code] = (char)0xFF;
+            log_bin_code = log_bin_index++;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 写入一个无符号变长整数，每字节7位，低位在前，最高位表示后面还有字节
+ * @param[in] value 数值
+ * @return 是否成功
+ */
+static bool letk_log_bin_varint(uint64_t value)
+{
+    while (value >= 0x80u)
+    {
+        if (!letk_log_bin_byte((uint8_t)(value | 0x80u)))
+        {
+            return false;
+        }
+        value >>= 7;
+    }
+    return letk_log_bin_byte((uint8_t)value);
+}
+
+/**
+ * @brief 写入一个参数
+ * @param[in] type 参数类型LETK_LOG_BIN_XXX
+ * @param[in] pargs 可变参数列表
+ * @return 是否成功
+ */
+static bool letk_log_bin_arg(uint32_t type, va_list* pargs)
+{
+    int64_t value;
+    uint32_t bits;
+    uint32_t len;
+    float f;
+    const char* str;
+
+    switch (type)
+    {
+    case LETK_LOG_BIN_INT:
+    case LETK_LOG_BIN_INT64:
+        /* 整数统一符号扩展后zigzag编码，小的负数也只占一两个字节，无符号数由解码工具按说明符截断 */
+        value = (type == LETK_LOG_BIN_INT) ? (int64_t)va_arg(*pargs, int) : (int64_t)va_arg(*pargs, long long);
+        return letk_log_bin_varint(((uint64_t)value << 1) ^ ((value < 0) ? UINT64_MAX : 0u));
+    case LETK_LOG_BIN_DOUBLE:
+        /* 浮点数按单精度小端输出 */
+        f = (float)va_arg(*pargs, double);
+        memcpy(&bits, &f, sizeof(bits));
+        for (len = 0; len < 4; len++)
+        {
+            if (!letk_log_bin_byte((uint8_t)(bits >> (len * 8))))
+            {
+                return false;
+            }
+        }
+        return true;
+    default:
+        str = va_arg(*pargs, const char*);
+        if (str == NULL)
+        {
+            str = "(null)";
+        }
+        for (len = 0; (len < LETK_LOG_BINARY_STR_MAX) && (str[len] != '\0'); len++)
+        {
+        }
+        if (!letk_log_bin_varint(len))
+        {
+            return false;
+        }
+        while (len-- > 0)
+        {
+            if (!letk_log_bin_byte((uint8_t)*str++))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+/**
+ * @brief 输出一条二进制日志
+ * @param[in] level 日志等级
+ * @param[in] id 字符串ID，即字典段中字符串的地址
+ * @param[in] types 低4位为参数个数，之后每2位为一个参数的类型LETK_LOG_BIN_XXX
+ * @param[in] pargs 可变参数列表
+ */
+static void letk_log_voutput_bin(letk_log_level_t level, uint32_t id, uint32_t types, va_list* pargs)
+{
+    uint32_t count = types & 0x0Fu;
+    uint32_t i;
+    int code;
+    int index;
+    bool ok;
+
+    if ((level < 0) || (level >= LETK_LOG_LEVEL_NONE))
+    {
+        return;
+    }
+
+#if LETK_LOG_SINK_ENABLE && !LETK_LOG_USE_PRINTF
+    /* 没有输出目标需要此等级时不编码 */
+    if ((letk_log_write_cb == NULL) && !letk_log_sink_wanted(level))
+    {
+        return;
+    }
+#endif  /* LETK_LOG_SINK_ENABLE && !LETK_LOG_USE_PRINTF */
+
+    /* 记录格式：等级和标志、字符串ID、[时间戳]、参数 */
+    log_bin_code = 0;
+    log_bin_index = 1;
+    ok = letk_log_bin_byte((uint8_t)level | (letk_log_time_cb ? LETK_LOG_BIN_FLAG_TIME : 0u)) &&
+         letk_log_bin_varint(id);
+    if (ok && letk_log_time_cb)
+    {
+        ok = letk_log_bin_varint(letk_log_time_cb());
+    }
+
+    for (i = 0; ok && (i < count); i++)
+    {
+        /* 缓存不足时丢弃写了一半的参数，解码工具对缺少的参数做标记 */
+        code = log_bin_code;
+        index = log_bin_index;
+        ok = letk_log_bin_arg((types >> (4 + 2 * i)) & 0x03u, pargs);
+        if (!ok)
+        {
+            log_bin_code = code;
+            log_bin_index = index;
+        }
+    }
+
+    /* 结束最后一个块，末尾添加分隔符 */
+    log_buf[log_bin_code] = (char)(log_bin_index - log_bin_code);
+    log_buf[log_bin_index++] = '\0';
+
+    if (letk_log_start_cb)
+    {
+        letk_log_start_cb();
+    }
+#if LETK_LOG_USE_PRINTF
+    fwrite(log_buf, 1, (size_t)log_bin_index, stdout);
+#else   /* LETK_LOG_USE_PRINTF */
+    if (letk_log_write_cb)
+    {
+        letk_log_write_cb((const uint8_t*)log_buf, (uint32_t)log_bin_index);
+    }
+#endif  /* LETK_LOG_USE_PRINTF */
+#if LETK_LOG_SINK_ENABLE
+    letk_log_sink_write(level, (const uint8_t*)log_buf, (uint32_t)log_bin_index);
+#endif  /* LETK_LOG_SINK_ENABLE */
+    if (letk_log_end_cb)
+    {
+        letk_log_end_cb();
+    }
+}
+
+/**
+ * @brief 输出一条二进制日志，此函数内部宏使用，用户不要直接使用
+ * @param[in] level 日志等级
+ * @param[in] id 字符串ID，即字典段中字符串的地址
+ * @param[in] types 低4位为参数个数，之后每2位为一个参数的类型LETK_LOG_BIN_XXX
+ * @param[in] ... 可变参数
+ */
+void letk_log_output_bin(letk_log_level_t level, uint32_t id, uint32_t types, ...)
+{
+    va_list args;
+
+    va_start(args, types);
+    letk_log_voutput_bin(level, id, types, &args);
+    va_end(args);
+}
+#endif  /* LETK_LOG_BINARY_ENABLE */
+
+/**
+ * @brief 输出一条日志
+ * @param[in] level 日志等级
+ * @param[in] loc 代码位置，编译期生成的"[文件名:行号 "
+ * @param[in] func 当前代码函数名
+ * @param[in] fmt 格式化字符串
+ * @param[in] pargs 可变参数列表，fmt中的格式排列
+ */
+static void letk_log_voutput(letk_log_level_t level, const char* loc, const char* func, const char* fmt,
+                             va_list* pargs)
+{
+    uint32_t time;
+#if LETK_LOG_ASYNC_SIZE > 0
+    letk_log_record_t rec;
+#else   /* LETK_LOG_ASYNC_SIZE > 0 */
+    int index;
+#if LETK_LOG_RING_SIZE > 0
+    /* 每个调用者在自己的栈上格式化 */
+    char buf[LETK_LOG_BUF_SIZE];
+#else   /* LETK_LOG_RING_SIZE > 0 */
+    char* buf = log_buf;
+#endif  /* LETK_LOG_RING_SIZE > 0 */
+#endif  /* LETK_LOG_ASYNC_SIZE > 0 */
+
+    if ((level < 0) || (level >= LETK_LOG_LEVEL_NONE))
+    {
+        return;
+    }
+
+#if LETK_LOG_SINK_ENABLE && !LETK_LOG_USE_PRINTF
+    /* 没有输出目标需要此等级时不格式化 */
+    if ((letk_log_puts_cb == NULL) && !letk_log_sink_wanted(level))
+    {
+        return;
+    }
+#endif  /* LETK_LOG_SINK_ENABLE && !LETK_LOG_USE_PRINTF */
+
+    time = letk_log_time_cb ? letk_log_time_cb() : 0;
+
+#if LETK_LOG_ASYNC_SIZE > 0
+    /* 只记录参数，格式化和输出在letk_log_flush中进行 */
+    rec.level = level;
+    rec.loc = loc;
+    rec.func = func;
+    rec.fmt = fmt;
+    rec.time = time;
+    letk_log_capture(&rec, pargs);
+    (void)letk_log_push(&rec);
+#else   /* LETK_LOG_ASYNC_SIZE > 0 */
+    index = letk_log_put_head(buf, level, time, loc, func);
+
+    /* 输出打印内容 */
+    index = letk_log_advance(index, LETK_LOG_VSNPRINTF(&buf[index], LETK_LOG_LINE_MAX + 1 - index, fmt, *pargs));
+
+#if LETK_LOG_RING_SIZE > 0
+    /* 整行提交，然后尝试输出 */
+    (void)letk_log_ring_push(level, buf, letk_log_end_line(buf, index));
+    letk_log_ring_drain();
+#else   /* LETK_LOG_RING_SIZE > 0 */
+    letk_log_put_line(level, index);
+#endif  /* LETK_LOG_RING_SIZE > 0 */
+#endif  /* LETK_LOG_ASYNC_SIZE > 0 */
+}
+
+/**
+ * @brief 输出一条日志，此函数内部宏使用，用户不要直接使用
+ * @param[in] level 日志等级
+ * @param[in] loc 代码位置，编译期生成的"[文件名:行号 "
+ * @param[in] func 当前代码函数名
+ * @param[in] fmt 格式化字符串
+ * @param[in] ... 可变参数，fmt中的格式排列
+ */
+void letk_log_output(letk_log_level_t level, const char* loc, const char* func, const char* fmt, ...)
+{
+    va_list args;
+
+    va_start(args, fmt);
+    letk_log_voutput(level, loc, func, fmt, &args);
+    va_end(args);
+}
+
+#if LETK_LOG_FILTER_ENABLE
+#if LETK_LOG_RATE_BURST > 0
+/**
+ * @brief 从调用点的令牌桶取一个令牌
+ * @param[in] ps 调用点
+ * @param[in] now 当前时间
+ * @return 是否取到令牌
+ */
+static bool letk_log_rate_take(letk_log_site_t* ps, uint32_t now)
+{
+    uint32_t count = (now - ps->time) / LETK_LOG_RATE_PERIOD;
+
+    /* 补充令牌，保留不足一个周期的时间 */
+    if (count >= ps->used)
+    {
+        ps->used = 0;
+        ps->time = now;
+    }
+    else
+    {
+        ps->used -= (uint16_t)count;
+        ps->time += count * LETK_LOG_RATE_PERIOD;
+    }
+
+    if (ps->used >= LETK_LOG_RATE_BURST)
+    {
+        ps->dropped++;
+        return false;
+    }
+    ps->used++;
+    return true;
+}
+#endif  /* LETK_LOG_RATE_BURST > 0 */
+
+#if LETK_LOG_BINARY_ENABLE
+/* 输出一条限流或重复提示，字典中的文件名和行号为空，解码时不显示代码位置 */
+#define LETK_LOG_NOTE(ps, level, fmt, count)                                                    \
+    do                                                                                          \
+    {                                                                                           \
+        static const char letk_log_str[] LETK_LOG_BINARY_SECTION = "\x1f\x1f" fmt;               \
+        (void)(ps);                                                                             \
+        letk_log_output_bin(level, (uint32_t)(uintptr_t)letk_log_str,                           \
+                            LETK_LOG_BIN_TYPES_1(fmt, count), count);                           \
+    } while (0)
+#else   /* LETK_LOG_BINARY_ENABLE */
+/* 输出一条限流或重复提示，使用被过滤调用点的代码位置和函数名 */
+#define LETK_LOG_NOTE(ps, level, fmt, count)    letk_log_output(level, (ps)->loc, (ps)->func, fmt, count)
+#endif  /* LETK_LOG_BINARY_ENABLE */
+
+#if LETK_LOG_REPEAT_MAX > 0
+/* FNV-1a哈希的初值和乘数 */
+#define LETK_LOG_HASH_BASIS     2166136261u
+#define LETK_LOG_HASH_PRIME     16777619u
+
+/**
+ * @brief 把一段数据累加到哈希值
+ * @param[in] hash 当前哈希值
+ * @param[in] data 数据
+ * @param[in] len 数据长度
+ * @return 新的哈希值
+ */
+static uint32_t letk_log_hash(uint32_t hash, const void* data, size_t len)
+{
+    const uint8_t* p = (const uint8_t*)data;
+
+    while (len-- > 0)
+    {
+        hash = (hash ^ *p++) * LETK_LOG_HASH_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * @brief 把一个字符串的内容累加到哈希值
+ * @param[in] hash 当前哈希值
+ * @param[in] str 字符串，可以为NULL
+ * @param[in] max 最多累加的字符数
+ * @return 新的哈希值
+ */
+static uint32_t letk_log_hash_str(uint32_t hash, const char* str, uint32_t max)
+{
+    if (str == NULL)
+    {
+        return hash * LETK_LOG_HASH_PRIME;
+    }
+    while ((max-- > 0) && (*str != '\0'))
+    {
+        hash = (hash ^ (uint8_t)*str++) * LETK_LOG_HASH_PRIME;
+    }
+    return hash * LETK_LOG_HASH_PRIME;
+}
+
+#if LETK_LOG_BINARY_ENABLE
+/**
+ * @brief 按类型描述计算参数指纹，只读取参数，不编码
+ * @param[in] types 低4位为参数个数，之后每2位为一个参数的类型LETK_LOG_BIN_XXX
+ * @param[in] pargs 可变参数列表
+ * @return 参数指纹
+ */
+static uint32_t letk_log_fingerprint(uint32_t types, va_list* pargs)
+{
+    uint32_t hash = LETK_LOG_HASH_BASIS;
+    uint32_t count = types & 0x0Fu;
+    uint32_t i;
+    long long value;
+    double real;
+
+    for (i = 0; i < count; i++)
+    {
+        switch ((types >> (4 + 2 * i)) & 0x03u)
+        {
+        case LETK_LOG_BIN_INT:
+            value = va_arg(*pargs, int);
+            hash = letk_log_hash(hash, &value, sizeof(value));
+            break;
+        case LETK_LOG_BIN_INT64:
+            value = va_arg(*pargs, long long);
+            hash = letk_log_hash(hash, &value, sizeof(value));
+            break;
+        case LETK_LOG_BIN_DOUBLE:
+            real = va_arg(*pargs, double);
+            hash = letk_log_hash(hash, &real, sizeof(real));
+            break;
+        default:
+            hash = letk_log_hash_str(hash, va_arg(*pargs, const char*), LETK_LOG_BINARY_STR_MAX);
+            break;
+        }
+    }
+    return hash;
+}
+#else   /* LETK_LOG_BINARY_ENABLE */
+/**
+ * @brief 按格式化字符串计算参数指纹，只读取参数，不格式化
+ * @param[in] fmt 格式化字符串
+ * @param[in] pargs 可变参数列表
+ * @return 参数指纹
+ * @note 带精度的%s可能没有结束符，只比较字符串地址，其余%s比较内容
+ */
+static uint32_t letk_log_fingerprint(const char* fmt, va_list* pargs)
+{
+    uint32_t hash = LETK_LOG_HASH_BASIS;
+    const char* p = fmt;
+    const char* str;
+    const void* ptr;
+    letk_log_spec_t spec;
+    uintmax_t value;
+    double real;
+    uint8_t i;
+
+    while ((p = strchr(p, '%')) != NULL)
+    {
+        letk_log_parse_spec(p, &spec);
+        p = spec.end;
+        if (spec.conv == '%')
+        {
+            continue;
+        }
+        if (spec.conv == 0)
+        {
+            /* 无法确定后续参数的类型，停止比较 */
+            break;
+        }
+        for (i = 0; i < spec.stars; i++)
+        {
+            value = (uintmax_t)(intmax_t)va_arg(*pargs, int);
+            hash = letk_log_hash(hash, &value, sizeof(value));
+        }
+        switch (spec.conv)
+        {
+        case 'd':
+        case 'i':
+            value = (uintmax_t)letk_log_arg_signed(spec.length, pargs);
+            hash = letk_log_hash(hash, &value, sizeof(value));
+            break;
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+            value = letk_log_arg_unsigned(spec.length, pargs);
+            hash = letk_log_hash(hash, &value, sizeof(value));
+            break;
+        case 'c':
+            value = (uintmax_t)va_arg(*pargs, int);
+            hash = letk_log_hash(hash, &value, sizeof(value));
+            break;
+        case 's':
+            str = va_arg(*pargs, const char*);
+            if (memchr(spec.start, '.', (size_t)(spec.end - spec.start)) != NULL)
+            {
+                hash = letk_log_hash(hash, &str, sizeof(str));
+            }
+            else
+            {
+                hash = letk_log_hash_str(hash, str, UINT32_MAX);
+            }
+            break;
+        case 'p':
+        case 'n':
+            ptr = va_arg(*pargs, const void*);
+            hash = letk_log_hash(hash, &ptr, sizeof(ptr));
+            break;
+        default:
+            real = (spec.length == LETK_LOG_LEN_BIG_L) ? (double)va_arg(*pargs, long double) : va_arg(*pargs, double);
+            hash = letk_log_hash(hash, &real, sizeof(real));
+            break;
+        }
+    }
+    return hash;
+}
+#endif  /* LETK_LOG_BINARY_ENABLE */
+#endif  /* LETK_LOG_REPEAT_MAX > 0 */
+
+/**
+ * @brief 判断一条日志是否输出
+ * @param[in] ps 调用点
+ * @param[in] level 日志等级
+ * @param[in] hash 参数指纹，不合并重复日志时不使用
+ * @return 是否输出
+ * @note 需要输出时先输出上一条日志的重复条数和本调用点被限流的条数
+ */
+static bool letk_log_filter_site(letk_log_site_t* ps, letk_log_level_t level, uint32_t hash)
+{
+    uint32_t now = letk_log_time_cb ? letk_log_time_cb() : 0;
+    uint32_t count;
+
+#if LETK_LOG_REPEAT_MAX > 0
+    /* 与上一条输出的日志调用点、等级和参数都相同，且没有超过合并时间，只计数；没有时间戳时不限合并时间 */
+    if ((ps == p_log_repeat_site) && (level == log_repeat_level) && (hash == log_repeat_hash) &&
+        (log_repeat_count < LETK_LOG_REPEAT_MAX) &&
+        ((letk_log_time_cb == NULL) || ((now - log_repeat_time) < LETK_LOG_REPEAT_PERIOD)))
+    {
+        log_repeat_count++;
+        return false;
+    }
+#endif  /* LETK_LOG_REPEAT_MAX > 0 */
+
+#if LETK_LOG_RATE_BURST > 0
+    /* 没有时间戳时不限流 */
+    if (letk_log_time_cb && !letk_log_rate_take(ps, now))
+    {
+        return false;
+    }
+#endif  /* LETK_LOG_RATE_BURST > 0 */
+
+#if LETK_LOG_REPEAT_MAX > 0
+    if (log_repeat_count > 0)
+    {
+        count = log_repeat_count;
+        log_repeat_count = 0;
+        LETK_LOG_NOTE(p_log_repeat_site, log_repeat_level, "last message repeated %u times", (unsigned int)count);
+    }
+    p_log_repeat_site = ps;
+    log_repeat_level = level;
+    log_repeat_hash = hash;
+    log_repeat_time = now;
+#endif  /* LETK_LOG_REPEAT_MAX > 0 */
+
+#if LETK_LOG_RATE_BURST > 0
+    if (ps->dropped > 0)
+    {
+        count = ps->dropped;
+        ps->dropped = 0;
+        LETK_LOG_NOTE(ps, level, "%u messages suppressed by rate limit", (unsigned int)count);
+    }
+#endif  /* LETK_LOG_RATE_BURST > 0 */
+
+    (void)count;
+    (void)level;
+    (void)hash;
+    (void)now;
+    return true;
+}
+
+#if LETK_LOG_REPEAT_MAX > 0
+#if LETK_LOG_BINARY_ENABLE
+/**
+ * @brief 按调用点过滤后输出一条二进制日志，此函数内部宏使用，用户不要直接使用
+ * @param[in] ps 调用点
+ * @param[in] level 日志等级
+ * @param[in] id 字符串ID，即字典段中字符串的地址
+ * @param[in] types 低4位为参数个数，之后每2位为一个参数的类型LETK_LOG_BIN_XXX
+ * @param[in] ... 可变参数
+ */
+void letk_log_output_bin_site(letk_log_site_t* ps, letk_log_level_t level, uint32_t id, uint32_t types, ...)
+{
+    va_list args;
+    uint32_t hash;
+
+    va_start(args, types);
+    hash = letk_log_fingerprint(types, &args);
+    va_end(args);
+    if (letk_log_filter_site(ps, level, hash))
+    {
+        va_start(args, types);
+        letk_log_voutput_bin(level, id, types, &args);
+        va_end(args);
+    }
+}
+#else   /* LETK_LOG_BINARY_ENABLE */
+/**
+ * @brief 按调用点过滤后输出一条日志，此函数内部宏使用，用户不要直接使用
+ * @param[in] ps 调用点，代码位置和函数名从调用点取
+ * @param[in] level 日志等级
+ * @param[in] fmt 格式化字符串
+ * @param[in] ... 可变参数，fmt中的格式排列
+ */
+void letk_log_output_site(letk_log_site_t* ps, letk_log_level_t level, const char* fmt, ...)
+{
+    va_list args;
+    uint32_t hash;
+
+    va_start(args, fmt);
+    hash = letk_log_fingerprint(fmt, &args);
+    va_end(args);
+    if (letk_log_filter_site(ps, level, hash))
+    {
+        va_start(args, fmt);
+        letk_log_voutput(level, ps->loc, ps->func, fmt, &args);
+        va_end(args);
+    }
+}
+#endif  /* LETK_LOG_BINARY_ENABLE */
+#else   /* LETK_LOG_REPEAT_MAX > 0 */
+/**
+ * @brief 判断一条日志是否输出，此函数内部宏使用，用户不要直接使用
+ * @param[in] ps 调用点
+ * @param[in] level 日志等级
+ * @return 是否输出，返回false时调用者不计算参数也不格式化
+ * @note 需要输出时先输出本调用点被限流的条数
+ */
+bool letk_log_filter(letk_log_site_t* ps, letk_log_level_t level)
+{
+    return letk_log_filter_site(ps, level, 0);
+}
+#endif  /* LETK_LOG_REPEAT_MAX > 0 */
+#endif  /* LETK_LOG_FILTER_ENABLE */
+
 #ifdef __cplusplus
 }
 #endif  /* __cplusplus */
@@ -13,6 +13,19 @@
 ** 修改日期         修改作者        修改内容
 ** 2022年5月29日    付瑞彪          创建文件，初次版本
 ** 2022年7月15日    付瑞彪          修改代码注释规范
+** 2026年10月18日   付瑞彪          增加异步日志，调用者只记录参数，格式化和输出延后到刷新时进行
+** 2026年10月18日   付瑞彪          增加二进制日志，格式化字符串放入不加载的段，由主机工具解码
+** 2026年10月18日   付瑞彪          代码位置和等级前缀在编译期生成，输出时不再查找文件名和格式化前缀
+** 2026年10月18日   付瑞彪          增加可选的轻量格式化，不依赖stdio
+** 2026年10月18日   付瑞彪          增加模块日志，每个模块有独立的运行时日志等级
+** 2026年10月18日   付瑞彪          增加按调用点的限流和重复日志合并，在格式化之前判断
+** 2026年10月18日   付瑞彪          增加多输出目标，每个目标有独立的最低等级，按长度输出
+** 2026年10月18日   付瑞彪          增加多线程行提交模式，调用者在栈上格式化，整行原子提交
+** 2026年10月18日   付瑞彪          限流和重复提示使用被过滤调用点的代码位置，二进制日志中不带代码位置
+** 2026年10月18日   付瑞彪          重复合并比较等级和参数指纹，超过合并时间后重新输出
+** 2026年10月18日   付瑞彪          二进制日志参数类型判断不再对void指针做算术运算
+** 2026年10月18日   付瑞彪          异步日志队列长度不能为1
+** 2026年10月18日   付瑞彪          输出时去掉文件路径改为由LETK_LOG_FILE_PATH显式使能
 **
 ***********************************************************************************************************************/
 #ifndef __LETK_LOG_H__
@@ -46,6 +59,9 @@
 #if LETK_LOG_ENABLE
 
 #include <stdint.h>
+#ifndef __cplusplus
+#include <stdbool.h>
+#endif  /* __cplusplus */
 
 #ifdef __cplusplus
 extern "C" {
@@ -62,11 +78,152 @@ typedef int8_t letk_log_level_t;
 #define LETK_LOG_USE_PRINTF     0
 #endif  /* LETK_LOG_USE_PRINTF */
 
+/* 默认使用标准库的vsnprintf格式化 */
+#ifndef LETK_LOG_USE_FMT
+#define LETK_LOG_USE_FMT        0
+#endif  /* LETK_LOG_USE_FMT */
+
+/* 默认不使能异步日志 */
+#ifndef LETK_LOG_ASYNC_SIZE
+#define LETK_LOG_ASYNC_SIZE     0
+#endif  /* LETK_LOG_ASYNC_SIZE */
+
+#ifndef LETK_LOG_ASYNC_ARGS
+#define LETK_LOG_ASYNC_ARGS     6
+#endif  /* LETK_LOG_ASYNC_ARGS */
+
+#ifndef LETK_LOG_ASYNC_MPSC
+#define LETK_LOG_ASYNC_MPSC     0
+#endif  /* LETK_LOG_ASYNC_MPSC */
+
+/* 长度为1时多生产者的序号无法区分空和满，未刷新的条目会被覆盖 */
+#if ((LETK_LOG_ASYNC_SIZE & (LETK_LOG_ASYNC_SIZE - 1)) != 0) || (LETK_LOG_ASYNC_SIZE == 1)
+#error LETK_LOG_ASYNC_SIZE must be 0 or a power of 2 not less than 2
+#endif
+
+#if (LETK_LOG_ASYNC_ARGS < 1) || (LETK_LOG_ASYNC_ARGS > 255)
+#error LETK_LOG_ASYNC_ARGS must be in range [1-255]
+#endif
+
+/* 默认不使能模块日志 */
+#ifndef LETK_LOG_MODULE_ENABLE
+#define LETK_LOG_MODULE_ENABLE  0
+#endif  /* LETK_LOG_MODULE_ENABLE */
+
+#ifndef LETK_LOG_MODULE_LEVEL
+#define LETK_LOG_MODULE_LEVEL   LETK_LOG_LEVEL
+#endif  /* LETK_LOG_MODULE_LEVEL */
+
+#ifndef LETK_LOG_MODULE_CLI_ENABLE
+#define LETK_LOG_MODULE_CLI_ENABLE  0
+#endif  /* LETK_LOG_MODULE_CLI_ENABLE */
+
+/* 默认不限流 */
+#ifndef LETK_LOG_RATE_BURST
+#define LETK_LOG_RATE_BURST     0
+#endif  /* LETK_LOG_RATE_BURST */
+
+#ifndef LETK_LOG_RATE_PERIOD
+#define LETK_LOG_RATE_PERIOD    100
+#endif  /* LETK_LOG_RATE_PERIOD */
+
+/* 默认不合并重复日志 */
+#ifndef LETK_LOG_REPEAT_MAX
+#define LETK_LOG_REPEAT_MAX     0
+#endif  /* LETK_LOG_REPEAT_MAX */
+
+#ifndef LETK_LOG_REPEAT_PERIOD
+#define LETK_LOG_REPEAT_PERIOD  1000
+#endif  /* LETK_LOG_REPEAT_PERIOD */
+
+#if (LETK_LOG_RATE_BURST < 0) || (LETK_LOG_RATE_BURST > 65535)
+#error LETK_LOG_RATE_BURST must be in range [0-65535]
+#endif
+
+#if LETK_LOG_RATE_PERIOD < 1
+#error LETK_LOG_RATE_PERIOD must be greater than 0
+#endif
+
+#if LETK_LOG_REPEAT_MAX < 0
+#error LETK_LOG_REPEAT_MAX must not be negative
+#endif
+
+#if LETK_LOG_REPEAT_PERIOD < 1
+#error LETK_LOG_REPEAT_PERIOD must be greater than 0
+#endif
+
+/* 默认不使能多输出目标 */
+#ifndef LETK_LOG_SINK_ENABLE
+#define LETK_LOG_SINK_ENABLE    0
+#endif  /* LETK_LOG_SINK_ENABLE */
+
+/* 默认不使能多线程行提交 */
+#ifndef LETK_LOG_RING_SIZE
+#define LETK_LOG_RING_SIZE      0
+#endif  /* LETK_LOG_RING_SIZE */
+
+#if (LETK_LOG_RING_SIZE & (LETK_LOG_RING_SIZE - 1)) != 0
+#error LETK_LOG_RING_SIZE must be 0 or a power of 2
+#endif
+
+#if (LETK_LOG_RING_SIZE > 0) && (LETK_LOG_RING_SIZE < 2 * LETK_LOG_BUF_SIZE)
+#error LETK_LOG_RING_SIZE must be at least twice LETK_LOG_BUF_SIZE
+#endif
+
+#if (LETK_LOG_RING_SIZE > 0) && ((LETK_LOG_ASYNC_SIZE > 0) || LETK_LOG_BINARY_ENABLE)
+#error LETK_LOG_RING_SIZE cannot be used together with LETK_LOG_ASYNC_SIZE or LETK_LOG_BINARY_ENABLE
+#endif
+
+/* 是否在格式化之前过滤日志 */
+#define LETK_LOG_FILTER_ENABLE  ((LETK_LOG_RATE_BURST > 0) || (LETK_LOG_REPEAT_MAX > 0))
+
+/* 默认不使能二进制日志 */
+#ifndef LETK_LOG_BINARY_ENABLE
+#define LETK_LOG_BINARY_ENABLE  0
+#endif  /* LETK_LOG_BINARY_ENABLE */
+
+#ifndef LETK_LOG_BINARY_STR_MAX
+#define LETK_LOG_BINARY_STR_MAX 32
+#endif  /* LETK_LOG_BINARY_STR_MAX */
+
+/* 字典段属性，默认使用GCC/Clang语法 */
+#ifndef LETK_LOG_BINARY_SECTION
+#define LETK_LOG_BINARY_SECTION __attribute__((section(".letk_log_str"), used))
+#endif  /* LETK_LOG_BINARY_SECTION */
+
+#if LETK_LOG_BINARY_ENABLE && (LETK_LOG_ASYNC_SIZE > 0)
+#error LETK_LOG_BINARY_ENABLE and LETK_LOG_ASYNC_SIZE cannot be used together
+#endif
+
+/* 代码文件名，必须是字符串常量，优先由构建系统为每个文件定义，
+ * 否则编译器支持__FILE_NAME__(GCC 12+/Clang 9+)时使用它，编译期已去掉路径，都不满足时使用__FILE__ */
+#ifndef LETK_LOG_FILE
+#ifdef __FILE_NAME__
+#define LETK_LOG_FILE           __FILE_NAME__
+#else   /* __FILE_NAME__ */
+#define LETK_LOG_FILE           __FILE__
+#endif  /* __FILE_NAME__ */
+#endif  /* LETK_LOG_FILE */
+
+/* 是否在输出时从LETK_LOG_FILE中去掉路径，默认不去掉 */
+#ifndef LETK_LOG_FILE_PATH
+#define LETK_LOG_FILE_PATH      0
+#endif  /* LETK_LOG_FILE_PATH */
+
+/* 字符串化 */
+#define LETK_LOG_STR_(x)        #x
+#define LETK_LOG_STR(x)         LETK_LOG_STR_(x)
+
+/* 日志输出钩子回调函数，提供钩子，用户可以实现高级功能，例如命令行的再现 */
+typedef void letk_log_hook_cb_t(void);
+/* 日志时间戳回调函数，单位由用户决定，例如letk_ticks_get_ms */
+typedef uint32_t letk_log_time_cb_t(void);
+/* 日志数据输出回调函数，用于二进制日志和输出目标 */
+typedef void letk_log_write_cb_t(const uint8_t* buf, uint32_t len);
+
 #if !LETK_LOG_USE_PRINTF
 /* 日志字符串输出回调函数 */
 typedef void letk_log_puts_cb_t(const char* str);
-/* 日志输出钩子回调函数，提供钩子，用户可以实现高级功能，例如命令行的再现 */
-typedef void letk_log_hook_cb_t(void);
 
 /**
  * @brief 日志系统初始化
@@ -83,16 +240,168 @@ void letk_log_init(letk_log_puts_cb_t* puts_cb);
  */
 void letk_log_set_hook_cb(letk_log_hook_cb_t* start_cb, letk_log_hook_cb_t* end_cb);
 
+/**
+ * @brief 设置日志时间戳回调函数
+ * @param[in] time_cb 时间戳回调函数，NULL表示不输出时间戳
+ * @note 时间戳在调用日志宏时读取，异步模式下也是日志产生的时刻
+ */
+void letk_log_set_time_cb(letk_log_time_cb_t* time_cb);
+
+#if LETK_LOG_SINK_ENABLE
+/* 日志输出目标 */
+typedef struct _letk_log_sink_t
+{
+    letk_log_write_cb_t* write_cb;      /* 数据输出回调函数，文本日志是包括换行不包括结束符的一行，二进制日志是一条记录 */
+    volatile letk_log_level_t level;    /* 最低等级，只有不小于这个等级的日志才会输出到此目标，可在运行时修改 */
+    struct _letk_log_sink_t* next;      /* 注册表下一个节点指针，不要随意摆弄 */
+} letk_log_sink_t;
+
+/**
+ * @brief 注册日志输出目标，已注册的只更新回调函数和等级
+ * @param[in] ps 输出目标指针，由调用者分配，注销前必须一直有效
+ * @param[in] write_cb 数据输出回调函数
+ * @param[in] level 最低等级
+ */
+void letk_log_sink_register(letk_log_sink_t* ps, letk_log_write_cb_t* write_cb, letk_log_level_t level);
+
+/**
+ * @brief 注销日志输出目标
+ * @param[in] ps 输出目标指针
+ */
+void letk_log_sink_unregister(letk_log_sink_t* ps);
+#endif  /* LETK_LOG_SINK_ENABLE */
+
+#if LETK_LOG_BINARY_ENABLE
+/**
+ * @brief 设置二进制日志的数据输出回调函数
+ * @param[in] write_cb 数据输出回调函数，每次输出一条完整的记录，使用printf时不需要设置
+ */
+void letk_log_set_write_cb(letk_log_write_cb_t* write_cb);
+
+/**
+ * @brief 输出一条二进制日志，此函数内部宏使用，用户不要直接使用
+ * @param[in] level 日志等级
+ * @param[in] id 字符串ID，即字典段中字符串的地址
+ * @param[in] types 低4位为参数个数，之后每2位为一个参数的类型LETK_LOG_BIN_XXX
+ * @param[in] ... 可变参数
+ */
+void letk_log_output_bin(letk_log_level_t level, uint32_t id, uint32_t types, ...);
+#endif  /* LETK_LOG_BINARY_ENABLE */
+
+#if LETK_LOG_ASYNC_SIZE > 0
+/**
+ * @brief 格式化并输出队列中的全部日志，在空闲任务或主循环中调用
+ * @return 输出的日志条数
+ * @note 只能在一个执行环境中调用，上次刷新以来有日志被丢弃时额外输出一行丢弃条数
+ */
+uint32_t letk_log_flush(void);
+#endif  /* LETK_LOG_ASYNC_SIZE > 0 */
+
+#if (LETK_LOG_ASYNC_SIZE > 0) || (LETK_LOG_RING_SIZE > 0)
+/**
+ * @brief 获取队列或缓存满而丢弃的日志条数
+ * @return 累计丢弃的日志条数
+ */
+uint32_t letk_log_get_dropped(void);
+#endif  /* (LETK_LOG_ASYNC_SIZE > 0) || (LETK_LOG_RING_SIZE > 0) */
+
+#if LETK_LOG_MODULE_ENABLE
+/* 日志模块 */
+typedef struct _letk_log_module_t
+{
+    const char* name;                   /* 模块名 */
+    volatile letk_log_level_t level;    /* 运行时日志等级，只有不小于这个等级的日志才会输出 */
+    struct _letk_log_module_t* next;    /* 注册表链接 */
+} letk_log_module_t;
+
+/**
+ * @brief 注册日志模块，已注册的不会重复添加，注册后才能按名称查找和修改等级
+ * @param[in] pm 日志模块指针
+ */
+void letk_log_module_register(letk_log_module_t* pm);
+
+/**
+ * @brief 遍历日志模块注册表
+ * @param[in] pm 当前日志模块指针，为NULL时返回第一个
+ * @return 下一个已注册的日志模块指针，NULL表示遍历结束
+ */
+letk_log_module_t* letk_log_module_next(const letk_log_module_t* pm);
+
+/**
+ * @brief 按名称设置已注册日志模块的运行时等级
+ * @param[in] name 模块名，"all"表示全部模块
+ * @param[in] level 日志等级，LETK_LOG_LEVEL_NONE表示关闭
+ * @return 是否找到模块
+ */
+bool letk_log_module_set_level(const char* name, letk_log_level_t level);
+
+#if LETK_LOG_MODULE_CLI_ENABLE
+/* 命令-log，查看和修改模块日志等级，静态注册命令时需要用户手动放入命令表 */
+void letk_log_cli_cmd(int argc, char* argv[]);
+#endif  /* LETK_LOG_MODULE_CLI_ENABLE */
+#endif  /* LETK_LOG_MODULE_ENABLE */
+
+#if LETK_LOG_FILTER_ENABLE
+/* 日志调用点，每个日志宏有一个静态实例 */
+typedef struct _letk_log_site_t
+{
+#if !LETK_LOG_BINARY_ENABLE
+    const char* loc;                    /* 代码位置，限流和重复提示使用 */
+    const char* func;                   /* 函数名，限流和重复提示使用 */
+#endif  /* !LETK_LOG_BINARY_ENABLE */
+#if LETK_LOG_RATE_BURST > 0
+    uint32_t time;                      /* 上次补充令牌的时间 */
+    uint32_t dropped;                   /* 上次输出以来被限流的条数 */
+    uint16_t used;                      /* 已用令牌数，0表示令牌桶满 */
+#elif LETK_LOG_BINARY_ENABLE
+    uint8_t reserved;                   /* 只用地址区分调用点 */
+#endif  /* LETK_LOG_RATE_BURST > 0 */
+} letk_log_site_t;
+
+#if LETK_LOG_REPEAT_MAX > 0
+#if LETK_LOG_BINARY_ENABLE
+/**
+ * @brief 按调用点过滤后输出一条二进制日志，此函数内部宏使用，用户不要直接使用
+ * @param[in] ps 调用点
+ * @param[in] level 日志等级
+ * @param[in] id 字符串ID，即字典段中字符串的地址
+ * @param[in] types 低4位为参数个数，之后每2位为一个参数的类型LETK_LOG_BIN_XXX
+ * @param[in] ... 可变参数
+ * @note 调用点、等级和参数指纹与上一条输出的日志都相同时只计数
+ */
+void letk_log_output_bin_site(letk_log_site_t* ps, letk_log_level_t level, uint32_t id, uint32_t types, ...);
+#else   /* LETK_LOG_BINARY_ENABLE */
+/**
+ * @brief 按调用点过滤后输出一条日志，此函数内部宏使用，用户不要直接使用
+ * @param[in] ps 调用点，代码位置和函数名从调用点取
+ * @param[in] level 日志等级
+ * @param[in] fmt 格式化字符串
+ * @param[in] ... 可变参数，fmt中的格式排列
+ * @note 调用点、等级和参数指纹与上一条输出的日志都相同时只计数
+ */
+void letk_log_output_site(letk_log_site_t* ps, letk_log_level_t level, const char* fmt, ...);
+#endif  /* LETK_LOG_BINARY_ENABLE */
+#else   /* LETK_LOG_REPEAT_MAX > 0 */
+/**
+ * @brief 判断一条日志是否输出，此函数内部宏使用，用户不要直接使用
+ * @param[in] ps 调用点
+ * @param[in] level 日志等级
+ * @return 是否输出，返回false时调用者不计算参数也不格式化
+ * @note 需要输出时先输出本调用点被限流的条数
+ */
+bool letk_log_filter(letk_log_site_t* ps, letk_log_level_t level);
+#endif  /* LETK_LOG_REPEAT_MAX > 0 */
+#endif  /* LETK_LOG_FILTER_ENABLE */
+
 /**
  * @brief 输出一条日志，此函数内部宏使用，用户不要直接使用
  * @param[in] level 日志等级
- * @param[in] file 当前代码路径
- * @param[in] line 当前代码行号
+ * @param[in] loc 代码位置，编译期生成的"[文件名:行号 "
  * @param[in] func 当前代码函数名
  * @param[in] fmt 格式化字符串
  * @param[in] ... 可变参数，fmt中的格式排列
  */
-void letk_log_output(letk_log_level_t level, const char* file, int line, const char* func, const char* fmt, ...);
+void letk_log_output(letk_log_level_t level, const char* loc, const char* func, const char* fmt, ...);
 
 #ifdef __cplusplus
 }   /* extern "C" */
@@ -100,38 +409,176 @@ void letk_log_output(letk_log_level_t level, const char* file, int line, const c
 
 #endif  /* LETK_LOG_ENABLE */
 
+#if LETK_LOG_BINARY_ENABLE
+/* 二进制日志参数类型 */
+#define LETK_LOG_BIN_INT        0u  /* 不大于int的整数和指针 */
+#define LETK_LOG_BIN_INT64      1u  /* 大于int的整数和指针 */
+#define LETK_LOG_BIN_DOUBLE     2u  /* 浮点数 */
+#define LETK_LOG_BIN_STRING     3u  /* 字符串 */
+
+/* 拼接 */
+#define LETK_LOG_CAT_(a, b)     a ## b
+#define LETK_LOG_CAT(a, b)      LETK_LOG_CAT_(a, b)
+/* 取格式化字符串，调用时末尾多传一个参数 */
+#define LETK_LOG_FIRST(fmt, ...) fmt
+/* 格式化字符串之后的参数个数，最多8个 */
+#define LETK_LOG_NARGS(...)     LETK_LOG_NARGS_(__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0, ~)
+#define LETK_LOG_NARGS_(fmt, a1, a2, a3, a4, a5, a6, a7, a8, n, ...) n
+
+/* 编译期按参数类型确定读取方式，需要编译器支持C11的_Generic，不支持long double，
+ * 整数取条件表达式的类型即提升后的类型，数组退化为指针，void指针也不涉及指针算术 */
+#define LETK_LOG_BIN_TYPE(a)    _Generic((a),                                                   \
+                                    char*: LETK_LOG_BIN_STRING,                                 \
+                                    const char*: LETK_LOG_BIN_STRING,                           \
+                                    float: LETK_LOG_BIN_DOUBLE,                                 \
+                                    double: LETK_LOG_BIN_DOUBLE,                                \
+                                    default: ((sizeof(1 ? (a) : (a)) <= sizeof(int)) ?          \
+                                              LETK_LOG_BIN_INT : LETK_LOG_BIN_INT64))
+#define LETK_LOG_BIN_T(n, a)    (LETK_LOG_BIN_TYPE(a) << (4 + 2 * (n)))
+
+/* 按参数个数生成类型描述 */
+#define LETK_LOG_BIN_TYPES_0(f)                                 0u
+#define LETK_LOG_BIN_TYPES_1(f, a)                              (1u | LETK_LOG_BIN_T(0, a))
+#define LETK_LOG_BIN_TYPES_2(f, a, b)                           (2u | LETK_LOG_BIN_T(0, a) | LETK_LOG_BIN_T(1, b))
+#define LETK_LOG_BIN_TYPES_3(f, a, b, c)                        (3u | LETK_LOG_BIN_T(0, a) | LETK_LOG_BIN_T(1, b) | \
+                                                                 LETK_LOG_BIN_T(2, c))
+#define LETK_LOG_BIN_TYPES_4(f, a, b, c, d)                     (4u | LETK_LOG_BIN_T(0, a) | LETK_LOG_BIN_T(1, b) | \
+                                                                 LETK_LOG_BIN_T(2, c) | LETK_LOG_BIN_T(3, d))
+#define LETK_LOG_BIN_TYPES_5(f, a, b, c, d, e)                  (5u | LETK_LOG_BIN_T(0, a) | LETK_LOG_BIN_T(1, b) | \
+                                                                 LETK_LOG_BIN_T(2, c) | LETK_LOG_BIN_T(3, d) | \
+                                                                 LETK_LOG_BIN_T(4, e))
+#define LETK_LOG_BIN_TYPES_6(f, a, b, c, d, e, g)               (6u | LETK_LOG_BIN_T(0, a) | LETK_LOG_BIN_T(1, b) | \
+                                                                 LETK_LOG_BIN_T(2, c) | LETK_LOG_BIN_T(3, d) | \
+                                                                 LETK_LOG_BIN_T(4, e) | LETK_LOG_BIN_T(5, g))
+#define LETK_LOG_BIN_TYPES_7(f, a, b, c, d, e, g, h)            (7u | LETK_LOG_BIN_T(0, a) | LETK_LOG_BIN_T(1, b) | \
+                                                                 LETK_LOG_BIN_T(2, c) | LETK_LOG_BIN_T(3, d) | \
+                                                                 LETK_LOG_BIN_T(4, e) | LETK_LOG_BIN_T(5, g) | \
+                                                                 LETK_LOG_BIN_T(6, h))
+#define LETK_LOG_BIN_TYPES_8(f, a, b, c, d, e, g, h, i)         (8u | LETK_LOG_BIN_T(0, a) | LETK_LOG_BIN_T(1, b) | \
+                                                                 LETK_LOG_BIN_T(2, c) | LETK_LOG_BIN_T(3, d) | \
+                                                                 LETK_LOG_BIN_T(4, e) | LETK_LOG_BIN_T(5, g) | \
+                                                                 LETK_LOG_BIN_T(6, h) | LETK_LOG_BIN_T(7, i))
+
+/* 按参数个数去掉格式化字符串，格式化字符串不能出现在运行时参数中，否则会被链接到加载的段 */
+#define LETK_LOG_BIN_ARGS_0(f)
+#define LETK_LOG_BIN_ARGS_1(f, a)                               , a
+#define LETK_LOG_BIN_ARGS_2(f, a, b)                            , a, b
+#define LETK_LOG_BIN_ARGS_3(f, a, b, c)                         , a, b, c
+#define LETK_LOG_BIN_ARGS_4(f, a, b, c, d)                      , a, b, c, d
+#define LETK_LOG_BIN_ARGS_5(f, a, b, c, d, e)                   , a, b, c, d, e
+#define LETK_LOG_BIN_ARGS_6(f, a, b, c, d, e, g)                , a, b, c, d, e, g
+#define LETK_LOG_BIN_ARGS_7(f, a, b, c, d, e, g, h)             , a, b, c, d, e, g, h
+#define LETK_LOG_BIN_ARGS_8(f, a, b, c, d, e, g, h, i)          , a, b, c, d, e, g, h, i
+
+/* 二进制日志，每个调用点在字典段生成一个"文件\x1f行号\x1f格式化字符串"，以其地址作为ID，
+ * 格式化字符串必须是字符串常量 */
+#define LETK_LOG_BIN_STR(...)                                                                   \
+        static const char letk_log_str[] LETK_LOG_BINARY_SECTION =                              \
+            LETK_LOG_FILE "\x1f" LETK_LOG_STR(__LINE__) "\x1f" LETK_LOG_FIRST(__VA_ARGS__, ~)
+/* 类型描述和去掉格式化字符串的参数 */
+#define LETK_LOG_BIN_TYPES_ARGS(...)                                                            \
+        LETK_LOG_CAT(LETK_LOG_BIN_TYPES_, LETK_LOG_NARGS(__VA_ARGS__))(__VA_ARGS__)             \
+        LETK_LOG_CAT(LETK_LOG_BIN_ARGS_, LETK_LOG_NARGS(__VA_ARGS__))(__VA_ARGS__)
+/* 输出一条二进制日志 */
+#define LETK_LOG_BIN(level, ...)                                                                \
+    do                                                                                          \
+    {                                                                                           \
+        LETK_LOG_BIN_STR(__VA_ARGS__);                                                          \
+        letk_log_output_bin(level, (uint32_t)(uintptr_t)letk_log_str, LETK_LOG_BIN_TYPES_ARGS(__VA_ARGS__)); \
+    } while (0)
+
+#define LETK_LOG_EMIT(level, ...)   LETK_LOG_BIN(level, __VA_ARGS__)
+#else   /* LETK_LOG_BINARY_ENABLE */
+/* 代码位置"[文件名:行号 " */
+#define LETK_LOG_LOC                "[" LETK_LOG_FILE ":" LETK_LOG_STR(__LINE__) " "
+#define LETK_LOG_EMIT(level, ...)   letk_log_output(level, LETK_LOG_LOC, __func__, __VA_ARGS__)
+#endif  /* LETK_LOG_BINARY_ENABLE */
+
+#if LETK_LOG_FILTER_ENABLE
+/* 调用点初值，文本日志记录代码位置，二进制日志全零 */
+#if LETK_LOG_BINARY_ENABLE
+#define LETK_LOG_SITE_INIT          { 0 }
+#elif LETK_LOG_RATE_BURST > 0
+#define LETK_LOG_SITE_INIT          { LETK_LOG_LOC, __func__, 0u, 0u, 0u }
+#else   /* LETK_LOG_BINARY_ENABLE */
+#define LETK_LOG_SITE_INIT          { LETK_LOG_LOC, __func__ }
+#endif  /* LETK_LOG_BINARY_ENABLE */
+
+#if LETK_LOG_REPEAT_MAX > 0
+/* 合并重复日志需要比较参数，参数只计算一次，过滤和输出在同一次函数调用中完成，被过滤的日志不格式化 */
+#if LETK_LOG_BINARY_ENABLE
+#define LETK_LOG_OUTPUT(level, ...)                                                             \
+    do                                                                                          \
+    {                                                                                           \
+        static letk_log_site_t letk_log_site = LETK_LOG_SITE_INIT;                              \
+        LETK_LOG_BIN_STR(__VA_ARGS__);                                                          \
+        letk_log_output_bin_site(&letk_log_site, level, (uint32_t)(uintptr_t)letk_log_str,      \
+                                 LETK_LOG_BIN_TYPES_ARGS(__VA_ARGS__));                         \
+    } while (0)
+#else   /* LETK_LOG_BINARY_ENABLE */
+#define LETK_LOG_OUTPUT(level, ...)                                                             \
+    do                                                                                          \
+    {                                                                                           \
+        static letk_log_site_t letk_log_site = LETK_LOG_SITE_INIT;                              \
+        letk_log_output_site(&letk_log_site, level, __VA_ARGS__);                               \
+    } while (0)
+#endif  /* LETK_LOG_BINARY_ENABLE */
+#else   /* LETK_LOG_REPEAT_MAX > 0 */
+/* 先按调用点判断限流，被过滤的日志只有一次函数调用，不计算参数也不格式化 */
+#define LETK_LOG_OUTPUT(level, ...)                                                             \
+    do                                                                                          \
+    {                                                                                           \
+        static letk_log_site_t letk_log_site = LETK_LOG_SITE_INIT;                              \
+        if (letk_log_filter(&letk_log_site, level))                                             \
+        {                                                                                       \
+            LETK_LOG_EMIT(level, __VA_ARGS__);                                                  \
+        }                                                                                       \
+    } while (0)
+#endif  /* LETK_LOG_REPEAT_MAX > 0 */
+#else   /* LETK_LOG_FILTER_ENABLE */
+#define LETK_LOG_OUTPUT(level, ...) LETK_LOG_EMIT(level, __VA_ARGS__)
+#endif  /* LETK_LOG_FILTER_ENABLE */
+
 /* 日志输出宏 */
 #if LETK_LOG_DEBUG_ENABLE
-#define LETK_LOG_DEBUG(...)     letk_log_output(LETK_LOG_LEVEL_DEBUG, __FILE__, __LINE__, __func__, __VA_ARGS__);
+#define LETK_LOG_DEBUG(...)     LETK_LOG_OUTPUT(LETK_LOG_LEVEL_DEBUG, __VA_ARGS__);
 #else   /* LETK_LOG_DEBUG_ENABLE */
 #define LETK_LOG_DEBUG(...)     (void)(0)
 #endif  /* LETK_LOG_DEBUG_ENABLE */
 
 #if LETK_LOG_INFO_ENABLE
-#define LETK_LOG_INFO(...)      letk_log_output(LETK_LOG_LEVEL_INFO, __FILE__, __LINE__, __func__, __VA_ARGS__);
+#define LETK_LOG_INFO(...)      LETK_LOG_OUTPUT(LETK_LOG_LEVEL_INFO, __VA_ARGS__);
 #else   /* LETK_LOG_INFO_ENABLE */
 #define LETK_LOG_INFO(...)      (void)(0)
 #endif  /* LETK_LOG_INFO_ENABLE */
 
 #if LETK_LOG_WARNING_ENABLE
-#define LETK_LOG_WARNING(...)   letk_log_output(LETK_LOG_LEVEL_WARNING, __FILE__, __LINE__, __func__, __VA_ARGS__);
+#define LETK_LOG_WARNING(...)   LETK_LOG_OUTPUT(LETK_LOG_LEVEL_WARNING, __VA_ARGS__);
 #else   /* LETK_LOG_WARNING_ENABLE */
 #define LETK_LOG_WARNING(...)   (void)(0)
 #endif  /* LETK_LOG_WARNING_ENABLE */
 
 #if LETK_LOG_ERROR_ENABLE
-#define LETK_LOG_ERROR(...)     letk_log_output(LETK_LOG_LEVEL_ERROR, __FILE__, __LINE__, __func__, __VA_ARGS__);
+#define LETK_LOG_ERROR(...)     LETK_LOG_OUTPUT(LETK_LOG_LEVEL_ERROR, __VA_ARGS__);
 #else   /* LETK_LOG_ERROR_ENABLE */
 #define LETK_LOG_ERROR(...)     (void)(0)
 #endif  /* LETK_LOG_ERROR_ENABLE */
 
+#if LETK_LOG_ASYNC_SIZE > 0
+/* 异步模式下断言失败后立即输出，否则死循环前日志不会输出 */
+#define LETK_LOG_ASSERT_FLUSH() (void)letk_log_flush()
+#else   /* LETK_LOG_ASYNC_SIZE > 0 */
+#define LETK_LOG_ASSERT_FLUSH() (void)(0)
+#endif  /* LETK_LOG_ASYNC_SIZE > 0 */
+
 #if LETK_LOG_ASSERT_ENABLE && LETK_LOG_ERROR_ENABLE
 /* 断言宏，归为错误，必须开启错误宏后才生效 */
 #define LETK_LOG_ASSERT(expr)   do                  \
                                 {                   \
                                     if (!(expr))    \
                                     {               \
-                                        letk_log_output(LETK_LOG_LEVEL_ERROR, __FILE__, __LINE__, __func__, #expr);\
+                                        LETK_LOG_EMIT(LETK_LOG_LEVEL_ERROR, #expr);\
+                                        LETK_LOG_ASSERT_FLUSH();\
                                         for (;;);   \
                                     }               \
                                 } while (0)
@@ -142,4 +589,30 @@ void letk_log_output(letk_log_level_t level, const char* file, int line, const c
 /* 通用日志打印宏，lvl_tag：打印等级，可取：DEBUG/WARNING/INFO/ERROR */
 #define LETK_LOG(lvl_tag, ...)  LETK_LOG_ ## lvl_tag(__VA_ARGS__)
 
+#if LETK_LOG_ENABLE && LETK_LOG_MODULE_ENABLE
+/* 定义日志模块，tag：模块名，例如HEAP，结尾不需要分号 */
+#define LETK_LOG_MODULE_DEFINE(tag)                                                             \
+        letk_log_module_t letk_log_module_ ## tag = { #tag, LETK_LOG_MODULE_LEVEL, NULL };
+/* 声明其他文件中定义的日志模块，结尾不需要分号 */
+#define LETK_LOG_MODULE_DECLARE(tag)                                                            \
+        extern letk_log_module_t letk_log_module_ ## tag;
+/* 注册日志模块 */
+#define LETK_LOG_MODULE_REGISTER(tag)   letk_log_module_register(&letk_log_module_ ## tag)
+/* 模块日志打印宏，先比较运行时等级，被过滤的日志不计算参数也不格式化，编译期去掉的等级不读取运行时等级 */
+#define LETK_LOG_MODULE(tag, lvl_tag, ...)                                                      \
+        do                                                                                      \
+        {                                                                                       \
+            if (LETK_LOG_ ## lvl_tag ## _ENABLE &&                                              \
+                (LETK_LOG_LEVEL_ ## lvl_tag >= letk_log_module_ ## tag.level))                  \
+            {                                                                                   \
+                LETK_LOG_ ## lvl_tag(__VA_ARGS__);                                              \
+            }                                                                                   \
+        } while (0)
+#else   /* LETK_LOG_ENABLE && LETK_LOG_MODULE_ENABLE */
+#define LETK_LOG_MODULE_DEFINE(tag)
+#define LETK_LOG_MODULE_DECLARE(tag)
+#define LETK_LOG_MODULE_REGISTER(tag)   (void)(0)
+#define LETK_LOG_MODULE(tag, lvl_tag, ...)  LETK_LOG(lvl_tag, __VA_ARGS__)
+#endif  /* LETK_LOG_ENABLE && LETK_LOG_MODULE_ENABLE */
+
 #endif  /* __LETK_LOG_H__ */
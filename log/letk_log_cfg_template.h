@@ -13,6 +13,15 @@
 ** 修改日期         修改作者        修改内容
 ** 2022年5月29日    付瑞彪          创建文件，初次版本
 ** 2022年7月15日    付瑞彪          修改代码注释规范
+** 2026年10月18日   付瑞彪          增加异步日志，调用者只记录参数，格式化和输出延后到刷新时进行
+** 2026年10月18日   付瑞彪          增加二进制日志配置
+** 2026年10月18日   付瑞彪          增加轻量格式化配置
+** 2026年10月18日   付瑞彪          增加模块日志配置
+** 2026年10月18日   付瑞彪          增加限流和重复日志合并配置
+** 2026年10月18日   付瑞彪          增加重复日志合并时间配置
+** 2026年10月18日   付瑞彪          增加多输出目标配置
+** 2026年10月18日   付瑞彪          增加多线程行提交缓存配置
+** 2026年10月18日   付瑞彪          增加输出时去掉文件路径配置
 **
 ***********************************************************************************************************************/
 #ifndef __LETK_LOG_CFG_H__
@@ -26,5 +35,46 @@
 #define LETK_LOG_BUF_SIZE       256
 /* 是否使用printf函数来打印日志，否则需要用户自己实现打印接口 */
 #define LETK_LOG_USE_PRINTF     0
+/* 是否使用letk_fmt轻量格式化代替vsnprintf，不依赖stdio，需要加入fmt模块，
+ * 只支持整数、字符、字符串和指针，浮点数说明符原样输出 */
+#define LETK_LOG_USE_FMT        0
+/* 是否在输出时从代码位置中去掉文件路径，每条日志都要扫描一遍位置字符串，
+ * 编译器支持__FILE_NAME__或构建系统为每个文件定义了LETK_LOG_FILE时不需要 */
+#define LETK_LOG_FILE_PATH      0
+/* 异步日志队列长度，必须是不小于2的2的N次幂，0表示不使能，使能后调用者只记录格式化字符串指针、参数和时间戳，
+ * 格式化和输出在letk_log_flush中进行，%s的参数必须是常量字符串等刷新时仍然有效的字符串 */
+#define LETK_LOG_ASYNC_SIZE     0
+/* 异步日志每条最多记录的参数个数，宽度和精度中的'*'也各占一个 */
+#define LETK_LOG_ASYNC_ARGS     6
+/* 异步日志队列是否支持多个生产者(多个中断优先级或多个线程)，需要编译器支持C11的stdatomic.h，
+ * 0表示只有一个生产者，仅依赖volatile */
+#define LETK_LOG_ASYNC_MPSC     0
+/* 是否使能模块日志，每个模块有独立的运行时日志等级，可在运行时修改，编译期被LETK_LOG_LEVEL去掉的日志不能再打开 */
+#define LETK_LOG_MODULE_ENABLE  0
+/* 模块日志的默认运行时等级，例如编译期保留DEBUG，运行时默认只输出INFO及以上 */
+#define LETK_LOG_MODULE_LEVEL   LETK_LOG_LEVEL
+/* 是否导出模块日志等级命令(log)，需要使能模块日志和CLI模块 */
+#define LETK_LOG_MODULE_CLI_ENABLE  0
+/* 每个调用点的令牌桶容量，即连续输出的最大条数，0表示不限流，需要设置时间戳回调函数，
+ * 被限流的日志不计算参数也不格式化，恢复输出时额外输出一行被限流的条数 */
+#define LETK_LOG_RATE_BURST     0
+/* 令牌补充周期，每过这么多时间单位(与时间戳回调函数相同)补充一个令牌，即稳定后的最大输出速率 */
+#define LETK_LOG_RATE_PERIOD    100
+/* 同一调用点连续产生的、等级和参数都相同的日志只输出第一条，之后只计数，最多合并的条数，0表示不合并，
+ * 使能后每条日志的参数都会计算以便比较，在下一条输出的日志之前、达到最大条数或超过合并时间时输出一行重复的条数 */
+#define LETK_LOG_REPEAT_MAX     0
+/* 合并时间，距上一条输出的日志超过这么多时间单位(与时间戳回调函数相同)后重复日志重新输出，没有时间戳时不限 */
+#define LETK_LOG_REPEAT_PERIOD  1000
+/* 是否使能多输出目标，每个输出目标有独立的最低等级，一条日志只格式化一次，按长度输出到所有目标 */
+#define LETK_LOG_SINK_ENABLE    0
+/* 多线程行提交环形缓存大小，单位：字节，必须是2的N次幂且不小于2倍LETK_LOG_BUF_SIZE，0表示不使能，
+ * 需要编译器支持C11的stdatomic.h，使能后每个调用者在自己的栈上格式化，整行通过一次原子预留放入缓存，
+ * 多个线程同时打印时行不会交错，不能与异步日志和二进制日志同时使能 */
+#define LETK_LOG_RING_SIZE      0
+/* 是否使能二进制日志，需要编译器支持C11的_Generic，不能与异步日志同时使能，使能后日志宏只输出等级、
+ * 字符串ID、时间戳和变长编码的参数，格式化字符串放入.letk_log_str段，由letk_log_decode.py还原成文本 */
+#define LETK_LOG_BINARY_ENABLE  0
+/* 二进制日志%s参数最多输出的字节数 */
+#define LETK_LOG_BINARY_STR_MAX 32
 
 #endif  /* __LETK_LOG_CFG_H__ */
@@ -0,0 +1,247 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+文件描述：二进制日志解码工具，从ELF文件的.letk_log_str段提取字典，把采集的二进制日志流还原成文本
+创建作者：付瑞彪(Tom Free)
+创建日期：2026年10月18日
+编码格式：UTF-8编码
+编程语言：Python 3，无第三方依赖
+开源许可：MIT许可证，参考：https://mit-license.org
+版权信息：Copyright (c) 2013-2022, Tom Free, <tomfreefu@gmail.com>
+
+使用方法：
+    python3 letk_log_decode.py firmware.elf capture.bin
+    cat /dev/ttyUSB0 | python3 letk_log_decode.py firmware.elf
+
+修改记录
+修改日期         修改作者        修改内容
+2026年10月18日   付瑞彪          创建文件，初次版本
+2026年10月18日   付瑞彪          文件名为空的字典项不显示代码位置，用于限流和重复提示
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+# 字典段名
+SECTION_NAME = ".letk_log_str"
+# 日志前缀，与letk_log.c中一致
+LEVEL_PREFIX = ["[D] ", "[I] ", "[W] ", "[E] "]
+# 记录首字节中表示带时间戳的标志
+FLAG_TIME = 0x08
+# 缺少的参数的标记
+MISSING = "<?>"
+
+# C格式说明符：标志、宽度、精度、长度修饰、转换字符
+SPEC_RE = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d*))?(hh|h|ll|l|j|z|t|L)?([diouxXcspfFeEgGaAn%])")
+
+
+def load_dict(path):
+    """从ELF文件中读取字典段，返回{ID: (文件, 行号, 格式化字符串)}"""
+    with open(path, "rb") as f:
+        elf = f.read()
+    if elf[:4] != b"\x7fELF":
+        raise ValueError("%s is not an ELF file" % path)
+    is64 = elf[4] == 2
+    end = "<" if elf[5] == 1 else ">"
+
+    if is64:
+        shoff, = struct.unpack_from(end + "Q", elf, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(end + "HHH", elf, 0x3A)
+        shdr = end + "IIQQQQ"
+    else:
+        shoff, = struct.unpack_from(end + "I", elf, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(end + "HHH", elf, 0x2E)
+        shdr = end + "IIIIII"
+
+    # 节头：名称、类型、标志、地址、文件偏移、大小
+    sections = [struct.unpack_from(shdr, elf, shoff + i * shentsize) for i in range(shnum)]
+    names = sections[shstrndx]
+    for name, _, _, addr, offset, size in sections:
+        start = names[4] + name
+        if elf[start:elf.index(b"\0", start)].decode() != SECTION_NAME:
+            continue
+        data = elf[offset:offset + size]
+        table = {}
+        i = 0
+        while i < len(data):
+            if data[i] == 0:
+                # 对齐填充
+                i += 1
+                continue
+            j = data.index(b"\0", i)
+            parts = data[i:j].decode("utf-8", "replace").split("\x1f", 2)
+            if len(parts) == 3:
+                table[(addr + i) & 0xFFFFFFFF] = (parts[0], parts[1], parts[2])
+            i = j + 1
+        return table
+    raise ValueError("section %s not found in %s" % (SECTION_NAME, path))
+
+
+def cobs_decode(frame):
+    """COBS解码一个记录，格式错误时返回None"""
+    out = bytearray()
+    i = 0
+    while i < len(frame):
+        code = frame[i]
+        if code == 0 or i + code > len(frame):
+            return None
+        out += frame[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < len(frame):
+            out.append(0)
+    return bytes(out)
+
+
+class Reader(object):
+    """记录内容读取器，数据不足时抛出IndexError"""
+
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def varint(self):
+        value = 0
+        shift = 0
+        while True:
+            b = self.data[self.pos]
+            self.pos += 1
+            value |= (b & 0x7F) << shift
+            shift += 7
+            if b < 0x80:
+                return value
+
+    def integer(self):
+        value = self.varint()
+        return (value >> 1) ^ -(value & 1)
+
+    def real(self):
+        if self.pos + 4 > len(self.data):
+            raise IndexError
+        value, = struct.unpack_from("<f", self.data, self.pos)
+        self.pos += 4
+        return value
+
+    def string(self):
+        length = self.varint()
+        if self.pos + length > len(self.data):
+            raise IndexError
+        value = self.data[self.pos:self.pos + length]
+        self.pos += length
+        return value.decode("utf-8", "replace")
+
+
+def int_bits(length, args):
+    """按长度修饰返回整数的位数"""
+    return {"hh": 8, "h": 16, "l": args.long_bits, "ll": 64, "j": 64,
+            "z": args.ptr_bits, "t": args.ptr_bits}.get(length, 32)
+
+
+def format_message(fmt, reader, args):
+    """按格式化字符串从记录中依次取出参数，还原日志正文"""
+    out = []
+    last = 0
+    for m in SPEC_RE.finditer(fmt):
+        out.append(fmt[last:m.start()])
+        last = m.end()
+        flags, width, prec, length, conv = m.groups()
+        if conv == "%":
+            out.append("%")
+            continue
+        try:
+            # '*'宽度和精度按int传递，负宽度表示左对齐，负精度表示未指定
+            if width == "*":
+                width = reader.integer()
+                if width < 0:
+                    flags += "-"
+                    width = -width
+                width = str(width)
+            if prec == "*":
+                prec = reader.integer()
+                prec = None if prec < 0 else str(prec)
+            spec = "%" + flags + (width or "") + ("." + prec if prec is not None else "")
+
+            if conv in "di":
+                bits = int_bits(length, args)
+                value = reader.integer() & ((1 << bits) - 1)
+                if value >> (bits - 1):
+                    value -= 1 << bits
+                out.append((spec + "d") % value)
+            elif conv in "ouxX":
+                value = reader.integer() & ((1 << int_bits(length, args)) - 1)
+                if conv == "o" and "#" in flags:
+                    # Python的#o前缀是0o
+                    out.append((spec.replace("#", "") + "s") % ("0%o" % value if value else "0"))
+                else:
+                    out.append((spec + ("d" if conv == "u" else conv)) % value)
+            elif conv == "c":
+                out.append((spec + "c") % chr(reader.integer() & 0xFF))
+            elif conv == "p":
+                value = reader.integer() & ((1 << args.ptr_bits) - 1)
+                out.append((spec.replace("0", "") + "s") % ("0x%x" % value))
+            elif conv == "s":
+                out.append((spec + "s") % reader.string())
+            elif conv in "aA":
+                value = reader.real().hex()
+                out.append((spec + "s") % (value.upper() if conv == "A" else value))
+            elif conv == "n":
+                continue
+            else:
+                out.append((spec + conv) % reader.real())
+        except IndexError:
+            # 缓存不足时输出端丢弃了后面的参数
+            out.append(MISSING)
+    out.append(fmt[last:])
+    return "".join(out)
+
+
+def decode_record(record, table, args):
+    """解码一条记录，返回文本行"""
+    reader = Reader(record)
+    try:
+        head = reader.varint()
+        sid = reader.varint()
+        time = reader.varint() if head & FLAG_TIME else None
+    except IndexError:
+        return "[?] truncated record: " + record.hex()
+    level = head & 0x07
+    prefix = LEVEL_PREFIX[level] if level < len(LEVEL_PREFIX) else "[?] "
+    if time is not None:
+        prefix += "[%u] " % time
+    if sid not in table:
+        return prefix + "unknown id 0x%08x: %s" % (sid, record[reader.pos:].hex())
+    file, line, fmt = table[sid]
+    if file:
+        prefix += "[%s:%s] " % (file, line)
+    return prefix + format_message(fmt, reader, args)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode letk binary log stream")
+    parser.add_argument("elf", help="ELF file built with LETK_LOG_BINARY_ENABLE")
+    parser.add_argument("stream", nargs="?", default="-", help="captured stream, default stdin")
+    parser.add_argument("--long-bits", type=int, default=32, help="bits of long on target, default 32")
+    parser.add_argument("--ptr-bits", type=int, default=32, help="bits of pointer and size_t on target, default 32")
+    args = parser.parse_args()
+
+    table = load_dict(args.elf)
+    if args.stream == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.stream, "rb") as f:
+            data = f.read()
+
+    # 0是记录分隔符，第一个分隔符之前可能是不完整的记录
+    for frame in data.split(b"\0"):
+        if not frame:
+            continue
+        record = cobs_decode(frame)
+        if record is None:
+            print("[?] bad frame: " + frame.hex())
+        else:
+            print(decode_record(record, table, args))
+
+
+if __name__ == "__main__":
+    main()
@@ -13,12 +13,18 @@
 ** 修改日期         修改作者        修改内容
 ** 2022年5月22日    付瑞彪          创建文件，初次版本
 ** 2022年7月15日    付瑞彪          修改代码注释规范
+** 2026年10月18日   付瑞彪          增加使用统计和统计注册表
+** 2026年10月18日   付瑞彪          增加缓冲区之间直接搬移数据的接口
+** 2026年10月18日   付瑞彪          统计命令按无符号数打印，超过2^31的值不再显示为负数
 **
 ***********************************************************************************************************************/
 
 #include "letk_rbuffer.h"
 #include <stddef.h>
 #include <string.h>
+#if LETK_RBUFFER_STATS_CLI_ENABLE
+#include "letk_cli.h"
+#endif  /* LETK_RBUFFER_STATS_CLI_ENABLE */
 
 #ifdef __cplusplus
 extern "C" {
@@ -27,6 +33,40 @@ extern "C" {
 /* 计算最小值 */
 #define LETK_RBUFFER_GET_MIN(a, b) ((a) < (b)) ? (a) : (b)
 
+#if LETK_RBUFFER_STATS_ENABLE
+/* 记录写入统计，want：期望写入字节数，done：实际写入字节数 */
+#define LETK_RBUFFER_STATS_WRITE(rb, want, done)                               \
+        do                                                                     \
+        {                                                                      \
+            uint32_t fill_ = (rb)->rear - (rb)->front;                         \
+            (rb)->stats.write_bytes += (done);                                 \
+            if (fill_ > (rb)->stats.max_fill)                                  \
+            {                                                                  \
+                (rb)->stats.max_fill = fill_;                                  \
+            }                                                                  \
+            if ((done) < (want))                                               \
+            {                                                                  \
+                (rb)->stats.overflow++;                                        \
+            }                                                                  \
+        } while (0)
+/* 记录读取统计，want：期望读取字节数，done：实际读取字节数 */
+#define LETK_RBUFFER_STATS_READ(rb, want, done)                                \
+        do                                                                     \
+        {                                                                      \
+            (rb)->stats.read_bytes += (done);                                  \
+            if ((done) < (want))                                               \
+            {                                                                  \
+                (rb)->stats.underflow++;                                       \
+            }                                                                  \
+        } while (0)
+
+/* 统计注册表头指针 */
+static letk_rbuffer_t* p_rbuffer_head = NULL;
+#else   /* LETK_RBUFFER_STATS_ENABLE */
+#define LETK_RBUFFER_STATS_WRITE(rb, want, done)    (void)(0)
+#define LETK_RBUFFER_STATS_READ(rb, want, done)     (void)(0)
+#endif  /* LETK_RBUFFER_STATS_ENABLE */
+
 /**
  * @brief 向下裁剪到2的N次幂
  * @param[in] x 数值
@@ -66,6 +106,9 @@ void letk_rbuffer_init(letk_rbuffer_t* rb, uint8_t* buf, uint32_t length)
     rb->buf = buf;
     rb->size = letk_rbuffer_trim_to_2_pow_n(length);
     rb->front = rb->rear = 0;
+#if LETK_RBUFFER_STATS_ENABLE
+    memset(&rb->stats, 0, sizeof(rb->stats));
+#endif  /* LETK_RBUFFER_STATS_ENABLE */
 }
 
 /**
@@ -101,10 +144,12 @@ bool letk_rbuffer_write_byte(letk_rbuffer_t* rb, uint8_t dat)
     {
         *(uint8_t*)(rb->buf + (rb->rear & (rb->size - 1))) = dat;
         rb->rear++;
+        LETK_RBUFFER_STATS_WRITE(rb, 1u, 1u);
         return true;
     }
     else
     {
+        LETK_RBUFFER_STATS_WRITE(rb, 1u, 0u);
         return false;
     }
 }
@@ -123,10 +168,12 @@ bool letk_rbuffer_read_byte(letk_rbuffer_t* rb, uint8_t* pdat)
     {
         *pdat = *(uint8_t*)(rb->buf + (rb->front & (rb->size - 1)));
         rb->front++;
+        LETK_RBUFFER_STATS_READ(rb, 1u, 1u);
         return true;
     }
     else
     {
+        LETK_RBUFFER_STATS_READ(rb, 1u, 0u);
         return false;
     }
 }
@@ -142,12 +189,16 @@ uint32_t letk_rbuffer_write_bytes(letk_rbuffer_t* rb, const uint8_t* buf, uint32
 {
     uint32_t i;
     uint32_t left;
+#if LETK_RBUFFER_STATS_ENABLE
+    uint32_t want = length;
+#endif  /* LETK_RBUFFER_STATS_ENABLE */
     left = rb->size + rb->front - rb->rear;
     length = LETK_RBUFFER_GET_MIN(length, left);
     i = LETK_RBUFFER_GET_MIN(length, rb->size - (rb->rear & (rb->size - 1)));
     memcpy(rb->buf + (rb->rear & (rb->size - 1)), buf, i);
     memcpy(rb->buf, buf + i, length - i);
     rb->rear += length;
+    LETK_RBUFFER_STATS_WRITE(rb, want, length);
     return length;
 }
 
@@ -162,15 +213,180 @@ uint32_t letk_rbuffer_read_bytes(letk_rbuffer_t* rb, uint8_t* buf, uint32_t leng
 {
     uint32_t i;
     uint32_t left;
+#if LETK_RBUFFER_STATS_ENABLE
+    uint32_t want = length;
+#endif  /* LETK_RBUFFER_STATS_ENABLE */
     left = rb->rear - rb->front;
     length = LETK_RBUFFER_GET_MIN(length, left);
     i = LETK_RBUFFER_GET_MIN(length, rb->size - (rb->front & (rb->size - 1)));
     memcpy(buf, rb->buf + (rb->front & (rb->size - 1)), i);
     memcpy(buf + i, rb->buf, length - i);
     rb->front += length;
+    LETK_RBUFFER_STATS_READ(rb, want, length);
     return length;
 }
 
+/**
+ * @brief 从一个环形缓冲区直接搬移数据到另一个环形缓冲区，无需中间缓存
+ * @param[in] dst 目的缓冲区实例指针(必须非NULL)
+ * @param[in] src 源缓冲区实例指针(必须非NULL，且不能与dst相同)
+ * @param[in] max 最多搬移的字节数
+ * @return 实际搬移的字节数，受源数据长度和目的剩余空间限制
+ */
+uint32_t letk_rbuffer_splice(letk_rbuffer_t* dst, letk_rbuffer_t* src, uint32_t max)
+{
+    uint32_t avail, room, length, done, chunk, soff, doff;
+
+    if (dst == src)
+    {
+        return 0;
+    }
+
+    /* 源可提供的数据和目的剩余空间 */
+    avail = src->rear - src->front;
+    avail = LETK_RBUFFER_GET_MIN(avail, max);
+    room = dst->size + dst->front - dst->rear;
+    length = LETK_RBUFFER_GET_MIN(avail, room);
+
+    /* 每次拷贝到源或目的的回绕边界为止，源和目的各最多回绕一次，最多分4段 */
+    for (done = 0; done < length; done += chunk)
+    {
+        soff = (src->front + done) & (src->size - 1);
+        doff = (dst->rear + done) & (dst->size - 1);
+        chunk = length - done;
+        chunk = LETK_RBUFFER_GET_MIN(chunk, src->size - soff);
+        chunk = LETK_RBUFFER_GET_MIN(chunk, dst->size - doff);
+        memcpy(dst->buf + doff, src->buf + soff, chunk);
+    }
+
+    src->front += length;
+    dst->rear += length;
+    LETK_RBUFFER_STATS_WRITE(dst, avail, length);
+    LETK_RBUFFER_STATS_READ(src, LETK_RBUFFER_GET_MIN(max, room), length);
+    return length;
+}
+
+#if LETK_RBUFFER_STATS_ENABLE
+/**
+ * @brief 注册环形缓冲区到统计注册表，已注册的不会重复添加
+ * @param[in] rb 缓冲区实例指针(必须非NULL)
+ * @param[in] name 缓冲区名称，用于统计信息显示，需要保证长期有效
+ */
+void letk_rbuffer_register(letk_rbuffer_t* rb, const char* name)
+{
+    const letk_rbuffer_t* p = p_rbuffer_head;
+
+    if (rb == NULL)
+    {
+        return;
+    }
+
+    rb->name = name;
+
+    /* 搜索是否已经存在于注册表中 */
+    while (p != NULL)
+    {
+        if (p == rb)
+        {
+            return;
+        }
+        p = p->next;
+    }
+
+    /* 添加到注册表头部 */
+    rb->next = p_rbuffer_head;
+    p_rbuffer_head = rb;
+}
+
+/**
+ * @brief 从统计注册表移除环形缓冲区
+ * @param[in] rb 缓冲区实例指针(必须非NULL)
+ */
+void letk_rbuffer_unregister(letk_rbuffer_t* rb)
+{
+    letk_rbuffer_t** pp = &p_rbuffer_head;
+
+    while (*pp != NULL)
+    {
+        if (*pp == rb)
+        {
+            /* 断链 */
+            *pp = rb->next;
+            rb->next = NULL;
+            return;
+        }
+        pp = &(*pp)->next;
+    }
+}
+
+/**
+ * @brief 遍历统计注册表
+ * @param[in] rb 当前缓冲区实例指针，为NULL时返回第一个
+ * @return 下一个已注册的缓冲区实例指针，NULL表示遍历结束
+ */
+letk_rbuffer_t* letk_rbuffer_next_registered(const letk_rbuffer_t* rb)
+{
+    return (rb == NULL) ? p_rbuffer_head : rb->next;
+}
+
+/**
+ * @brief 获取环形缓冲区的使用统计
+ * @param[in] rb 缓冲区实例指针(必须非NULL)
+ * @return 使用统计指针
+ */
+const letk_rbuffer_stats_t* letk_rbuffer_get_stats(const letk_rbuffer_t* rb)
+{
+    return &rb->stats;
+}
+
+/**
+ * @brief 清除环形缓冲区的使用统计，最大数据长度重置为当前数据长度
+ * @param[in] rb 缓冲区实例指针(必须非NULL)
+ */
+void letk_rbuffer_reset_stats(letk_rbuffer_t* rb)
+{
+    memset(&rb->stats, 0, sizeof(rb->stats));
+    rb->stats.max_fill = rb->rear - rb->front;
+}
+
+#if LETK_RBUFFER_STATS_CLI_ENABLE
+/* 打印一个字段，name：字段名，val：字段值 */
+static void letk_rbuffer_cli_put_field(const char* name, uint32_t val)
+{
+    letk_cli_put_str(name);
+    letk_cli_put_uint(val);
+}
+
+/* 命令-rbuffer，列出全部已注册缓冲区的统计信息 */
+void letk_rbuffer_cli_cmd(int argc, char* argv[])
+{
+    const letk_rbuffer_t* rb = p_rbuffer_head;
+
+    (void)argc;
+    (void)argv;
+
+    while (rb != NULL)
+    {
+        letk_cli_put_str("    ");
+        letk_cli_put_str((rb->name != NULL) ? rb->name : "?");
+        letk_rbuffer_cli_put_field(": size=", rb->size);
+        letk_rbuffer_cli_put_field(" used=", rb->rear - rb->front);
+        letk_rbuffer_cli_put_field(" max=", rb->stats.max_fill);
+        letk_rbuffer_cli_put_field(" wr=", rb->stats.write_bytes);
+        letk_rbuffer_cli_put_field(" rd=", rb->stats.read_bytes);
+        letk_rbuffer_cli_put_field(" ovf=", rb->stats.overflow);
+        letk_rbuffer_cli_put_field(" udf=", rb->stats.underflow);
+        letk_cli_put_str("\r\n");
+        rb = rb->next;
+    }
+}
+/* 导出rbuffer命令 */
+LETK_CLI_CMD_EXPORT(rbuffer,
+                  "rbuffer -- list the usage statistics of ring buffers",
+                  letk_rbuffer_cli_cmd);
+#endif  /* LETK_RBUFFER_STATS_CLI_ENABLE */
+#endif  /* LETK_RBUFFER_STATS_ENABLE */
+
 #ifdef __cplusplus
 }
 #endif  /* __cplusplus */
@@ -13,11 +13,14 @@
 ** 修改日期         修改作者        修改内容
 ** 2022年5月22日    付瑞彪          创建文件，初次版本
 ** 2022年7月15日    付瑞彪          修改代码注释规范
+** 2026年10月18日   付瑞彪          增加使用统计和统计注册表
+** 2026年10月18日   付瑞彪          增加缓冲区之间直接搬移数据的接口
 **
 ***********************************************************************************************************************/
 #ifndef __LETK_RBUFFER_H__
 #define __LETK_RBUFFER_H__
 
+#include "letk_rbuffer_cfg.h"
 #include <stdint.h>
 #ifndef __cplusplus
 #include <stdbool.h>
@@ -27,14 +30,43 @@
 extern "C" {
 #endif  /* __cplusplus */
 
-/* 环形缓冲区管理器，用户不要去直接操作内部成员变量 */
+/* 默认不使能统计功能 */
+#ifndef LETK_RBUFFER_STATS_ENABLE
+#define LETK_RBUFFER_STATS_ENABLE       0
+#endif  /* LETK_RBUFFER_STATS_ENABLE */
+
+#ifndef LETK_RBUFFER_STATS_CLI_ENABLE
+#define LETK_RBUFFER_STATS_CLI_ENABLE   0
+#endif  /* LETK_RBUFFER_STATS_CLI_ENABLE */
+
+#if LETK_RBUFFER_STATS_ENABLE
+/* 环形缓冲区使用统计 */
 typedef struct
+{
+    uint32_t max_fill;      /* 历史最大数据长度 */
+    uint32_t write_bytes;   /* 累计写入字节数 */
+    uint32_t read_bytes;    /* 累计读取字节数 */
+    uint32_t overflow;      /* 写入被拒绝(全部或部分)的次数 */
+    uint32_t underflow;     /* 读取不足(全部或部分)的次数 */
+} letk_rbuffer_stats_t;
+#endif  /* LETK_RBUFFER_STATS_ENABLE */
+
+/* 环形缓冲区管理器类型定义 */
+typedef struct _letk_rbuffer_t letk_rbuffer_t;
+
+/* 环形缓冲区管理器，用户不要去直接操作内部成员变量 */
+struct _letk_rbuffer_t
 {
      uint8_t* buf;      /* 环形缓冲区地址 */
      uint32_t size;     /* 环形缓冲区大小 */
      uint32_t front;    /* 头指针 */
      uint32_t rear;     /* 尾指针 */
-} letk_rbuffer_t;
+#if LETK_RBUFFER_STATS_ENABLE
+     letk_rbuffer_stats_t stats;    /* 使用统计 */
+     const char* name;              /* 注册名称 */
+     letk_rbuffer_t* next;          /* 注册表下一个节点指针，不要随意摆弄 */
+#endif  /* LETK_RBUFFER_STATS_ENABLE */
+};
 
 /**
  * @brief 初始化一个环形缓冲区
@@ -91,6 +123,55 @@ uint32_t letk_rbuffer_write_bytes(letk_rbuffer_t* rb, const uint8_t* buf, uint32
  */
 uint32_t letk_rbuffer_read_bytes(letk_rbuffer_t* rb, uint8_t* buf, uint32_t length);
 
+/**
+ * @brief 从一个环形缓冲区直接搬移数据到另一个环形缓冲区，无需中间缓存
+ * @param[in] dst 目的缓冲区实例指针(必须非NULL)
+ * @param[in] src 源缓冲区实例指针(必须非NULL，且不能与dst相同)
+ * @param[in] max 最多搬移的字节数
+ * @return 实际搬移的字节数，受源数据长度和目的剩余空间限制
+ */
+uint32_t letk_rbuffer_splice(letk_rbuffer_t* dst, letk_rbuffer_t* src, uint32_t max);
+
+#if LETK_RBUFFER_STATS_ENABLE
+/**
+ * @brief 注册环形缓冲区到统计注册表，已注册的不会重复添加
+ * @param[in] rb 缓冲区实例指针(必须非NULL)
+ * @param[in] name 缓冲区名称，用于统计信息显示，需要保证长期有效
+ */
+void letk_rbuffer_register(letk_rbuffer_t* rb, const char* name);
+
+/**
+ * @brief 从统计注册表移除环形缓冲区
+ * @param[in] rb 缓冲区实例指针(必须非NULL)
+ */
+void letk_rbuffer_unregister(letk_rbuffer_t* rb);
+
+/**
+ * @brief 遍历统计注册表
+ * @param[in] rb 当前缓冲区实例指针，为NULL时返回第一个
+ * @return 下一个已注册的缓冲区实例指针，NULL表示遍历结束
+ */
+letk_rbuffer_t* letk_rbuffer_next_registered(const letk_rbuffer_t* rb);
+
+/**
+ * @brief 获取环形缓冲区的使用统计
+ * @param[in] rb 缓冲区实例指针(必须非NULL)
+ * @return 使用统计指针
+ */
+const letk_rbuffer_stats_t* letk_rbuffer_get_stats(const letk_rbuffer_t* rb);
+
+/**
+ * @brief 清除环形缓冲区的使用统计，最大数据长度重置为当前数据长度
+ * @param[in] rb 缓冲区实例指针(必须非NULL)
+ */
+void letk_rbuffer_reset_stats(letk_rbuffer_t* rb);
+
+#if LETK_RBUFFER_STATS_CLI_ENABLE
+/* 命令-rbuffer，列出全部已注册缓冲区的统计信息，静态注册命令时需要用户手动放入命令表 */
+void letk_rbuffer_cli_cmd(int argc, char* argv[]);
+#endif  /* LETK_RBUFFER_STATS_CLI_ENABLE */
+#endif  /* LETK_RBUFFER_STATS_ENABLE */
+
 #ifdef __cplusplus
 }
 #endif  /* __cplusplus */
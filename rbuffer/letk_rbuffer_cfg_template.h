@@ -0,0 +1,25 @@
+/***********************************************************************************************************************
+** 文件描述：环形缓冲区配置文件
+** 创建作者：付瑞彪(Tom Free)
+** 创建日期：2026年10月18日
+** 编码格式：UTF-8编码
+** 编程语言：C语言，C99标准
+** 缩进格式：4个空格键
+** 命名规范：下划线命名法(小写命名法)
+** 开源许可：MIT许可证，参考：https://mit-license.org
+** 版权信息：Copyright (c) 2013-2022, Tom Free, <tomfreefu@gmail.com>
+**
+** 修改记录
+** 修改日期         修改作者        修改内容
+** 2026年10月18日   付瑞彪          创建文件，初次版本
+**
+***********************************************************************************************************************/
+#ifndef __LETK_RBUFFER_CFG_H__
+#define __LETK_RBUFFER_CFG_H__
+
+/* 是否使能环形缓冲区使用统计，用于评估缓冲区大小是否合适 */
+#define LETK_RBUFFER_STATS_ENABLE       0
+/* 是否导出统计信息查看命令(rbuffer)，需要使能统计功能和CLI模块 */
+#define LETK_RBUFFER_STATS_CLI_ENABLE   0
+
+#endif  /* __LETK_RBUFFER_CFG_H__ */
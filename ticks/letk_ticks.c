@@ -13,31 +13,232 @@
 ** 修改日期         修改作者        修改内容
 ** 2022年5月29日    付瑞彪          创建文件，初次版本
 ** 2022年7月15日    付瑞彪          修改代码注释规范
+** 2026年10月18日   付瑞彪          增加无滴答休眠补偿接口
+** 2026年10月18日   付瑞彪          增加64位us时间戳和硬件计数器钩子
+** 2026年10月18日   付瑞彪          增加多核安全的序号锁读取方式
+** 2026年10月18日   付瑞彪          序号锁保护的数据改为relaxed原子变量
+** 2026年10月18日   付瑞彪          计数器折算us改为乘以预先计算的定点倒数再移位，不再做除法
 **
 ***********************************************************************************************************************/
 
 #include "letk_ticks.h"
+#include <stddef.h>
+#if LETK_TICKS_SEQLOCK_ENABLE
+#include <stdatomic.h>
+#endif  /* LETK_TICKS_SEQLOCK_ENABLE */
 
 #ifdef __cplusplus
 extern "C" {
 #endif  /* __cplusplus */
 
+#if LETK_TICKS_SEQLOCK_ENABLE
+/* 序号锁保护的数据也用原子变量，读取者与写入者并行访问时才不构成C11的数据竞争，
+ * 只需relaxed访问，顺序由序号的栅栏保证，全部为32位以内，32位多核MCU上也是无锁的 */
+#define LETK_TICKS_DATA(type)           _Atomic(type)
+#define LETK_TICKS_LOAD(var)            atomic_load_explicit(&(var), memory_order_relaxed)
+#define LETK_TICKS_STORE(var, val)      atomic_store_explicit(&(var), (val), memory_order_relaxed)
+#else
+#define LETK_TICKS_DATA(type)           type
+#define LETK_TICKS_LOAD(var)            (var)
+#define LETK_TICKS_STORE(var, val)      ((var) = (val))
+#endif  /* LETK_TICKS_SEQLOCK_ENABLE */
+
 /* 系统运行总的ms数 */
-static uint32_t sys_all_ms = 0;
+static LETK_TICKS_DATA(uint32_t) sys_all_ms = 0;
 /* 滴答中断标志，因为系统时钟滴答是多字节（32位）的，为了保证原子操作，
  * 防止8位或16位CPU下，系统时钟滴答读取操作时被中断出现字节撕裂现象
  * 此处必须是一个byte类型，防止这个标志也因为是多字节被撕裂，
  * 且必须加volatile关键字，用于每次都进行内存操作而非使用寄存器中的值 */
 static volatile uint8_t tick_irq_flag;
 
+#if LETK_TICKS_SEQLOCK_ENABLE
+/* 序号，写入期间为奇数，读取前后序号相同且为偶数时读取的数据有效，
+ * 写入者不等待，读取者与写入者可以运行在不同的核或线程上，
+ * 注意同一核上不能在写入者执行期间被读取者抢占(例如滴答中断中途被更高优先级中断读取)，否则读取者会一直等待 */
+static atomic_uint tick_seq;
+
+/**
+ * @brief 开始写入，序号变为奇数
+ */
+static inline void letk_ticks_write_begin(void)
+{
+    unsigned int seq = atomic_load_explicit(&tick_seq, memory_order_relaxed);
+
+    atomic_store_explicit(&tick_seq, seq + 1u, memory_order_relaxed);
+    /* 保证序号先于数据可见 */
+    atomic_thread_fence(memory_order_release);
+}
+
+/**
+ * @brief 结束写入，序号变为偶数
+ */
+static inline void letk_ticks_write_end(void)
+{
+    unsigned int seq = atomic_load_explicit(&tick_seq, memory_order_relaxed);
+
+    /* 保证数据先于序号可见 */
+    atomic_store_explicit(&tick_seq, seq + 1u, memory_order_release);
+}
+
+/**
+ * @brief 开始读取，等待正在进行的写入完成
+ * @return 读取开始时的序号
+ */
+static inline unsigned int letk_ticks_read_begin(void)
+{
+    unsigned int seq;
+
+    while ((seq = atomic_load_explicit(&tick_seq, memory_order_acquire)) & 1u)
+    {
+    }
+    return seq;
+}
+
+/**
+ * @brief 判断读取期间是否发生了写入
+ * @param[in] seq 读取开始时的序号
+ * @return 是否需要重新读取
+ */
+static inline bool letk_ticks_read_retry(unsigned int seq)
+{
+    /* 保证数据读取先于再次读取序号 */
+    atomic_thread_fence(memory_order_acquire);
+    return (atomic_load_explicit(&tick_seq, memory_order_relaxed) != seq);
+}
+
+#define LETK_TICKS_WRITE_BEGIN()    letk_ticks_write_begin()
+#define LETK_TICKS_WRITE_END()      letk_ticks_write_end()
+#define LETK_TICKS_READ_BEGIN(seq)  ((seq) = letk_ticks_read_begin())
+#define LETK_TICKS_READ_RETRY(seq)  letk_ticks_read_retry(seq)
+#else
+#define LETK_TICKS_WRITE_BEGIN()    (tick_irq_flag = 0)
+#define LETK_TICKS_WRITE_END()      ((void)0)
+#define LETK_TICKS_READ_BEGIN(seq)  ((void)(seq), tick_irq_flag = 1)
+#define LETK_TICKS_READ_RETRY(seq)  (!tick_irq_flag)
+#endif  /* LETK_TICKS_SEQLOCK_ENABLE */
+/* ms数溢出的次数，与sys_all_ms组成64位ms数 */
+static LETK_TICKS_DATA(uint32_t) sys_ms_high = 0;
+
+/* 硬件计数器钩子 */
+static LETK_TICKS_DATA(letk_ticks_counter_cb_t*) counter_cb = NULL;
+/* 计数器每us的计数值 */
+static LETK_TICKS_DATA(uint32_t) counter_div = 1;
+/* 计数器每us计数值的定点倒数和移位数，计数值折算为us时用乘法和移位代替除法 */
+static LETK_TICKS_DATA(uint32_t) counter_mul = 1;
+static LETK_TICKS_DATA(uint8_t) counter_sh1 = 0;
+static LETK_TICKS_DATA(uint8_t) counter_sh2 = 0;
+/* 计数器上一次同步时的计数值，不足1us的部分留在计数器中 */
+static LETK_TICKS_DATA(uint32_t) counter_last = 0;
+/* 计数器上一次同步时累计的us数，分为高低32位保存 */
+static LETK_TICKS_DATA(uint32_t) counter_us_low = 0;
+static LETK_TICKS_DATA(uint32_t) counter_us_high = 0;
+
+/**
+ * @brief 累加ms数，处理32位溢出
+ * @param[in] ms 流逝的ms数
+ */
+static void letk_ticks_add_ms(uint32_t ms)
+{
+    uint32_t old = LETK_TICKS_LOAD(sys_all_ms);
+
+    LETK_TICKS_STORE(sys_all_ms, old + ms);
+    if (old + ms < old)
+    {
+        LETK_TICKS_STORE(sys_ms_high, LETK_TICKS_LOAD(sys_ms_high) + 1u);
+    }
+}
+
+/**
+ * @brief 将计数值折算为us数，等于计数值除以每us的计数值，对任意32位计数值都精确
+ * @param[in] counts 计数值
+ * @param[in] mul 定点倒数
+ * @param[in] sh1 第一次移位数
+ * @param[in] sh2 第二次移位数
+ * @return us数
+ */
+static inline uint32_t letk_ticks_counts_to_us(uint32_t counts, uint32_t mul, uint8_t sh1, uint8_t sh2)
+{
+    uint32_t t = (uint32_t)(((uint64_t)counts * mul) >> 32);
+
+    return (t + ((counts - t) >> sh1)) >> sh2;
+}
+
+/**
+ * @brief 读取计数器累计的us数
+ * @return 累计的us数
+ */
+static uint64_t letk_ticks_get_counter_us(void)
+{
+    return (((uint64_t)LETK_TICKS_LOAD(counter_us_high)) << 32) | LETK_TICKS_LOAD(counter_us_low);
+}
+
+/**
+ * @brief 设置计数器累计的us数，只在写入期间调用
+ * @param[in] us 累计的us数
+ */
+static void letk_ticks_set_counter_us(uint64_t us)
+{
+    LETK_TICKS_STORE(counter_us_high, (uint32_t)(us >> 32));
+    LETK_TICKS_STORE(counter_us_low, (uint32_t)us);
+}
+
 /**
  * @brief 系统增加指定的ms数
  * @param[in] ms 一个tick流逝的ms数
  */
 void letk_ticks_inc_ms(uint32_t ms)
 {
-    tick_irq_flag = 0;
-    sys_all_ms += ms;
+    letk_ticks_counter_cb_t* cb;
+    uint32_t last;
+    uint32_t div;
+    uint32_t us;
+
+    LETK_TICKS_WRITE_BEGIN();
+    letk_ticks_add_ms(ms);
+
+    /* 每个滴答把计数器的增量折算到64位us数，读取时只需计算一个滴答内的增量 */
+    cb = LETK_TICKS_LOAD(counter_cb);
+    if (cb != NULL)
+    {
+        last = LETK_TICKS_LOAD(counter_last);
+        div = LETK_TICKS_LOAD(counter_div);
+        us = letk_ticks_counts_to_us(cb() - last, LETK_TICKS_LOAD(counter_mul),
+                                     LETK_TICKS_LOAD(counter_sh1), LETK_TICKS_LOAD(counter_sh2));
+        letk_ticks_set_counter_us(letk_ticks_get_counter_us() + us);
+        LETK_TICKS_STORE(counter_last, last + us * div);
+    }
+    LETK_TICKS_WRITE_END();
+}
+
+/**
+ * @brief 无滴答休眠唤醒后，一次性补偿休眠期间流逝的ms数
+ * @param[in] ms 休眠的ms数
+ * @note 调用期间滴答中断必须处于停止状态，否则需要自行进行临界段保护
+ */
+void letk_ticks_skip_ms(uint32_t ms)
+{
+    letk_ticks_counter_cb_t* cb;
+    uint32_t now;
+    uint64_t us;
+
+    LETK_TICKS_WRITE_BEGIN();
+    letk_ticks_add_ms(ms);
+
+    /* 休眠期间计数器可能停止，取计数器增量和补偿时间中较大的一个，保证时间戳单调递增 */
+    cb = LETK_TICKS_LOAD(counter_cb);
+    if (cb != NULL)
+    {
+        now = cb();
+        us = letk_ticks_counts_to_us(now - LETK_TICKS_LOAD(counter_last), LETK_TICKS_LOAD(counter_mul),
+                                     LETK_TICKS_LOAD(counter_sh1), LETK_TICKS_LOAD(counter_sh2));
+        if (us < (uint64_t)ms * 1000u)
+        {
+            us = (uint64_t)ms * 1000u;
+        }
+        letk_ticks_set_counter_us(letk_ticks_get_counter_us() + us);
+        LETK_TICKS_STORE(counter_last, now);
+    }
+    LETK_TICKS_WRITE_END();
 }
 
 /**
@@ -47,16 +248,99 @@ void letk_ticks_inc_ms(uint32_t ms)
 uint32_t letk_ticks_get_ms(void)
 {
     uint32_t result;
+    unsigned int seq = 0;
 
     do
     {
-        tick_irq_flag = 1;
-        result = sys_all_ms;
-    } while (!tick_irq_flag);
+        LETK_TICKS_READ_BEGIN(seq);
+        result = LETK_TICKS_LOAD(sys_all_ms);
+    } while (LETK_TICKS_READ_RETRY(seq));
 
     return result;
 }
 
+/**
+ * @brief 设置高精度时间戳使用的硬件计数器
+ * @param[in] cb 硬件计数器钩子，NULL表示只使用ms计数
+ * @param[in] counts_per_us 计数器每us的计数值
+ */
+void letk_ticks_set_counter(letk_ticks_counter_cb_t* cb, uint32_t counts_per_us)
+{
+    uint32_t high;
+    uint32_t ms;
+    uint32_t div = (counts_per_us > 0) ? counts_per_us : 1u;
+    uint32_t shift = 0;
+    unsigned int seq = 0;
+
+    /* 预先计算定点倒数，shift为不小于log2(div)的最小整数，
+     * mul = floor(2^32 * (2^shift - div) / div) + 1，小于2^32 */
+    while ((shift < 32u) && ((((uint64_t)1) << shift) < div))
+    {
+        shift++;
+    }
+
+    /* 从当前的ms数开始计时，保证切换前后时间戳连续 */
+    do
+    {
+        LETK_TICKS_READ_BEGIN(seq);
+        high = LETK_TICKS_LOAD(sys_ms_high);
+        ms = LETK_TICKS_LOAD(sys_all_ms);
+    } while (LETK_TICKS_READ_RETRY(seq));
+
+    LETK_TICKS_WRITE_BEGIN();
+    LETK_TICKS_STORE(counter_cb, NULL);
+    LETK_TICKS_STORE(counter_div, div);
+    LETK_TICKS_STORE(counter_mul, (uint32_t)((((((uint64_t)1) << shift) - div) << 32) / div + 1u));
+    LETK_TICKS_STORE(counter_sh1, (uint8_t)((shift > 0) ? 1u : 0u));
+    LETK_TICKS_STORE(counter_sh2, (uint8_t)((shift > 0) ? (shift - 1u) : 0u));
+    letk_ticks_set_counter_us(((((uint64_t)high) << 32) | ms) * 1000u);
+    if (cb != NULL)
+    {
+        LETK_TICKS_STORE(counter_last, cb());
+    }
+    LETK_TICKS_STORE(counter_cb, cb);
+    LETK_TICKS_WRITE_END();
+}
+
+/**
+ * @brief 获取系统当前的us数，64位不会溢出
+ * @return 系统当前的us数
+ */
+uint64_t letk_ticks_get_us64(void)
+{
+    uint64_t base;
+    uint32_t last;
+    uint32_t now;
+    uint32_t high;
+    uint32_t ms;
+    uint32_t mul;
+    uint8_t sh1;
+    uint8_t sh2;
+    letk_ticks_counter_cb_t* cb;
+    unsigned int seq = 0;
+
+    /* 与读取ms数相同，读取期间发生写入时重新读取，保证64位数据不被撕裂 */
+    do
+    {
+        LETK_TICKS_READ_BEGIN(seq);
+        cb = LETK_TICKS_LOAD(counter_cb);
+        high = LETK_TICKS_LOAD(sys_ms_high);
+        ms = LETK_TICKS_LOAD(sys_all_ms);
+        base = letk_ticks_get_counter_us();
+        last = LETK_TICKS_LOAD(counter_last);
+        mul = LETK_TICKS_LOAD(counter_mul);
+        sh1 = LETK_TICKS_LOAD(counter_sh1);
+        sh2 = LETK_TICKS_LOAD(counter_sh2);
+        now = (cb != NULL) ? cb() : 0;
+    } while (LETK_TICKS_READ_RETRY(seq));
+
+    if (cb == NULL)
+    {
+        return ((((uint64_t)high) << 32) | ms) * 1000u;
+    }
+    return base + letk_ticks_counts_to_us(now - last, mul, sh1, sh2);
+}
+
 /**
  * @brief 获取相对于上一时刻流逝的ms数
  * @param[in] last_ms 上一时刻的ms值
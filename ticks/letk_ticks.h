@@ -13,11 +13,15 @@
 ** 修改日期         修改作者        修改内容
 ** 2022年5月29日    付瑞彪          创建文件，初次版本
 ** 2022年7月15日    付瑞彪          修改代码注释规范
+** 2026年10月18日   付瑞彪          增加无滴答休眠补偿接口
+** 2026年10月18日   付瑞彪          增加64位us时间戳和硬件计数器钩子
+** 2026年10月18日   付瑞彪          增加多核安全的序号锁读取方式
 **
 ***********************************************************************************************************************/
 #ifndef __LETK_TICKS_H__
 #define __LETK_TICKS_H__
 
+#include "letk_ticks_cfg.h"
 #include <stdint.h>
 #ifndef __cplusplus
 #include <stdbool.h>
@@ -27,18 +31,47 @@
 extern "C" {
 #endif  /* __cplusplus */
 
+/* 默认使用中断标志重读 */
+#ifndef LETK_TICKS_SEQLOCK_ENABLE
+#define LETK_TICKS_SEQLOCK_ENABLE   0
+#endif  /* LETK_TICKS_SEQLOCK_ENABLE */
+
+/* 硬件计数器钩子原型定义，返回自由运行的32位计数值，允许溢出回绕 */
+typedef uint32_t letk_ticks_counter_cb_t(void);
+
 /**
  * @brief 系统增加指定的ms数
  * @param[in] ms 一个tick流逝的ms数
  */
 void letk_ticks_inc_ms(uint32_t ms);
 
+/**
+ * @brief 无滴答休眠唤醒后，一次性补偿休眠期间流逝的ms数
+ * @param[in] ms 休眠的ms数
+ * @note 调用期间滴答中断必须处于停止状态，否则需要自行进行临界段保护
+ */
+void letk_ticks_skip_ms(uint32_t ms);
+
 /**
  * @brief 获取系统当前的ms数
  * @return 系统当前的ms数
  */
 uint32_t letk_ticks_get_ms(void);
 
+/**
+ * @brief 设置高精度时间戳使用的硬件计数器
+ * @param[in] cb 硬件计数器钩子，例如DWT周期计数器、SysTick外的自由运行定时器，NULL表示只使用ms计数
+ * @param[in] counts_per_us 计数器每us的计数值，例如72MHz的周期计数器为72
+ * @note 两次letk_ticks_inc_ms之间计数器不能回绕一圈以上
+ */
+void letk_ticks_set_counter(letk_ticks_counter_cb_t* cb, uint32_t counts_per_us);
+
+/**
+ * @brief 获取系统当前的us数，64位不会溢出
+ * @return 系统当前的us数，未设置硬件计数器时精度为ms
+ */
+uint64_t letk_ticks_get_us64(void);
+
 /**
  * @brief 获取相对于上一时刻流逝的ms数
  * @param[in] last_ms 上一时刻的ms值
@@ -0,0 +1,24 @@
+/***********************************************************************************************************************
+** 文件描述：滴答时钟管理配置文件
+** 创建作者：付瑞彪(Tom Free)
+** 创建日期：2026年10月18日
+** 编码格式：UTF-8编码
+** 编程语言：C语言，C99标准
+** 缩进格式：4个空格键
+** 命名规范：下划线命名法(小写命名法)
+** 开源许可：MIT许可证，参考：https://mit-license.org
+** 版权信息：Copyright (c) 2013-2022, Tom Free, <tomfreefu@gmail.com>
+**
+** 修改记录
+** 修改日期         修改作者        修改内容
+** 2026年10月18日   付瑞彪          创建文件，初次版本
+**
+***********************************************************************************************************************/
+#ifndef __LETK_TICKS_CFG_H__
+#define __LETK_TICKS_CFG_H__
+
+/* 是否使用序号锁(seqlock)保护时基读取，用于多核或多线程下读取者与写入者并行运行的场合，
+ * 需要编译器支持C11的stdatomic.h，0表示使用中断标志重读，只适合写入者是同一核上的中断 */
+#define LETK_TICKS_SEQLOCK_ENABLE       0
+
+#endif  /* __LETK_TICKS_CFG_H__ */
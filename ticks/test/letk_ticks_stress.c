@@ -0,0 +1,194 @@
+/***********************************************************************************************************************
+** 文件描述：滴答时钟多线程压力测试，一个写入者线程不停累加时间，多个读取者线程检查时间戳不会倒退
+** 创建作者：付瑞彪(Tom Free)
+** 创建日期：2026年10月18日
+** 编码格式：UTF-8编码
+** 编程语言：C语言，C11标准
+** 缩进格式：4个空格键
+** 命名规范：下划线命名法(小写命名法)
+** 开源许可：MIT许可证，参考：https://mit-license.org
+** 版权信息：Copyright (c) 2013-2022, Tom Free, <tomfreefu@gmail.com>
+**
+** 修改记录
+** 修改日期         修改作者        修改内容
+** 2026年10月18日   付瑞彪          创建文件，初次版本
+**
+***********************************************************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+
+#include "letk_ticks.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* 默认读取者线程数量，可由第一个命令行参数指定 */
+#define STRESS_READERS_DEFAULT  4u
+/* 最多读取者线程数量 */
+#define STRESS_READERS_MAX      64u
+/* 每个阶段默认运行的ms数，可由第二个命令行参数指定 */
+#define STRESS_RUN_MS_DEFAULT   1000u
+/* 每写入多少次做一次大跨度累加，让ms数频繁跨越32位溢出 */
+#define STRESS_JUMP_PERIOD      1000u
+/* 大跨度累加的ms数 */
+#define STRESS_JUMP_MS          0x01000000u
+/* 模拟硬件计数器每us的计数值 */
+#define STRESS_COUNTS_PER_US    10u
+
+/* 读取者线程的统计 */
+typedef struct
+{
+    unsigned long reads;        /* 读取次数 */
+    unsigned long errors;       /* 时间戳倒退的次数 */
+} stress_reader_t;
+
+/* 通知所有线程结束 */
+static atomic_bool stress_stop;
+/* 写入次数 */
+static unsigned long stress_writes;
+
+/**
+ * @brief 获取单调时钟的ns时间戳
+ * @return ns时间戳
+ */
+static uint64_t stress_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief 模拟的32位自由运行硬件计数器
+ * @return 计数值
+ */
+static uint32_t stress_counter(void)
+{
+    return (uint32_t)(stress_ns() / (1000u / STRESS_COUNTS_PER_US));
+}
+
+/**
+ * @brief 写入者线程，模拟滴答中断和无滴答休眠补偿
+ * @param[in] arg 未使用
+ * @return NULL
+ */
+static void* stress_writer(void* arg)
+{
+    unsigned long n = 0;
+
+    (void)arg;
+    while (!atomic_load(&stress_stop))
+    {
+        n++;
+        if ((n % STRESS_JUMP_PERIOD) == 0)
+        {
+            letk_ticks_skip_ms(STRESS_JUMP_MS);
+        }
+        else
+        {
+            letk_ticks_inc_ms(1);
+        }
+    }
+    stress_writes += n;
+    return NULL;
+}
+
+/**
+ * @brief 读取者线程，检查64位us时间戳不会倒退
+ * @param[in] arg 读取者统计
+ * @return NULL
+ * @note 写入者的大跨度累加会让32位ms数在两次读取之间回绕，ms数不做检查
+ */
+static void* stress_reader(void* arg)
+{
+    stress_reader_t* pr = (stress_reader_t*)arg;
+    uint64_t us, last_us;
+
+    last_us = letk_ticks_get_us64();
+    while (!atomic_load(&stress_stop))
+    {
+        us = letk_ticks_get_us64();
+        if (us < last_us)
+        {
+            if (pr->errors++ < 5u)
+            {
+                printf("backwards: us %llu -> %llu\n", (unsigned long long)last_us, (unsigned long long)us);
+            }
+        }
+        last_us = us;
+        pr->reads++;
+    }
+    return NULL;
+}
+
+/**
+ * @brief 运行一个阶段，一个写入者和多个读取者并行运行指定的时间
+ * @param[in] name 阶段名称
+ * @param[in] readers 读取者数量
+ * @param[in] run_ms 运行的ms数
+ * @return 时间戳倒退的次数
+ */
+static unsigned long stress_phase(const char* name, uint32_t readers, uint32_t run_ms)
+{
+    pthread_t writer;
+    pthread_t reader[STRESS_READERS_MAX];
+    stress_reader_t stats[STRESS_READERS_MAX] = { { 0, 0 } };
+    struct timespec ts;
+    unsigned long reads = 0, errors = 0;
+    uint32_t i;
+
+    atomic_store(&stress_stop, false);
+    stress_writes = 0;
+    for (i = 0; i < readers; i++)
+    {
+        pthread_create(&reader[i], NULL, stress_reader, &stats[i]);
+    }
+    pthread_create(&writer, NULL, stress_writer, NULL);
+
+    ts.tv_sec = run_ms / 1000u;
+    ts.tv_nsec = (long)(run_ms % 1000u) * 1000000L;
+    nanosleep(&ts, NULL);
+    atomic_store(&stress_stop, true);
+
+    pthread_join(writer, NULL);
+    for (i = 0; i < readers; i++)
+    {
+        pthread_join(reader[i], NULL);
+        reads += stats[i].reads;
+        errors += stats[i].errors;
+    }
+    printf("%-8s writes=%lu reads=%lu backwards=%lu us64=%llu\n", name, stress_writes, reads, errors,
+           (unsigned long long)letk_ticks_get_us64());
+    return errors;
+}
+
+/**
+ * @brief 主函数
+ * @param[in] argc 参数数量
+ * @param[in] argv 参数列表，argv[1]为读取者数量，argv[2]为每个阶段运行的ms数
+ * @return 0：通过，1：失败
+ */
+int main(int argc, char* argv[])
+{
+    uint32_t readers = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : STRESS_READERS_DEFAULT;
+    uint32_t run_ms = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : STRESS_RUN_MS_DEFAULT;
+    unsigned long errors;
+
+    if ((readers == 0) || (readers > STRESS_READERS_MAX))
+    {
+        readers = STRESS_READERS_DEFAULT;
+    }
+
+    /* 从接近32位溢出处开始，只用ms数换算us */
+    letk_ticks_inc_ms(0xFFFFF000u);
+    errors = stress_phase("ms", readers, run_ms);
+
+    /* 接入硬件计数器，us数由计数器增量累加 */
+    letk_ticks_set_counter(stress_counter, STRESS_COUNTS_PER_US);
+    errors += stress_phase("counter", readers, run_ms);
+
+    printf("%s\n", (errors == 0) ? "PASS" : "FAIL");
+    return (errors == 0) ? 0 : 1;
+}
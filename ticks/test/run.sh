@@ -0,0 +1,10 @@
+#!/bin/sh
+# 在主机上编译并运行滴答时钟多线程压力测试
+# 用法：sh ticks/test/run.sh [读取者数量] [每个阶段运行的ms数]，编译器由环境变量CC指定，默认cc，
+# 额外的编译选项由环境变量CFLAGS指定，例如CFLAGS=-fsanitize=thread
+set -e
+cd "$(dirname "$0")"
+CC=${CC:-cc}
+OUT=${TMPDIR:-/tmp}
+$CC -std=c11 -O2 -Wall -pthread $CFLAGS -I. -I.. ../letk_ticks.c letk_ticks_stress.c -o "$OUT/letk_ticks_stress"
+"$OUT/letk_ticks_stress" "$@"
@@ -0,0 +1,206 @@
+/***********************************************************************************************************************
+** 文件描述：定时器频繁添加移除的基准测试，验证移除和添加的耗时与定时器数量无关
+** 创建作者：付瑞彪(Tom Free)
+** 创建日期：2026年10月18日
+** 编码格式：UTF-8编码
+** 编程语言：C语言，C99标准
+** 缩进格式：4个空格键
+** 命名规范：下划线命名法(小写命名法)
+** 开源许可：MIT许可证，参考：https://mit-license.org
+** 版权信息：Copyright (c) 2013-2022, Tom Free, <tomfreefu@gmail.com>
+**
+** 修改记录
+** 修改日期         修改作者        修改内容
+** 2026年10月18日   付瑞彪          创建文件，初次版本
+**
+***********************************************************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+
+#include "letk_timer.h"
+#include "letk_ticks.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* 每种定时器数量下的操作次数 */
+#define BENCH_OPS               200000u
+
+#if LETK_TIMER_ENGINE == LETK_TIMER_ENGINE_LIST
+#define BENCH_ENGINE_NAME       "list"
+#elif LETK_TIMER_ENGINE == LETK_TIMER_ENGINE_WHEEL
+#define BENCH_ENGINE_NAME       "wheel"
+#else
+#define BENCH_ENGINE_NAME       "heap"
+#endif  /* LETK_TIMER_ENGINE */
+
+/* 单向链表节点，用于对照改为双向链表之前按遍历查找前驱的移除方式 */
+typedef struct bench_node bench_node_t;
+struct bench_node
+{
+    bench_node_t* next;
+};
+
+/* 测试的定时器数量 */
+static const uint32_t bench_sizes[] = { 100u, 1000u, 10000u };
+/* 伪随机数种子，固定初值保证每次运行相同 */
+static uint32_t bench_seed = 1;
+
+/**
+ * @brief 生成伪随机数
+ * @return 伪随机数
+ */
+static uint32_t bench_rand(void)
+{
+    bench_seed = bench_seed * 1103515245u + 12345u;
+    return bench_seed >> 8;
+}
+
+/**
+ * @brief 获取单调时钟的ns时间戳
+ * @return ns时间戳
+ */
+static uint64_t bench_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief 定时器回调，不做任何事
+ * @param[in] ptimer 定时器指针
+ */
+static void bench_cb(letk_timer_t* ptimer)
+{
+    (void)ptimer;
+}
+
+/**
+ * @brief 随机挑选已添加并启动的定时器，移除后立即添加回去
+ * @param[in] timers 定时器数组
+ * @param[in] count 定时器数量
+ * @return 平均每对移除和添加的ns数
+ */
+static double bench_remove_add(letk_timer_t* timers, uint32_t count)
+{
+    uint64_t begin;
+    uint32_t i;
+    letk_timer_t* pt;
+
+    begin = bench_ns();
+    for (i = 0; i < BENCH_OPS; i++)
+    {
+        pt = &timers[bench_rand() % count];
+        letk_timer_remove(pt);
+        letk_timer_add(pt);
+    }
+    return (double)(bench_ns() - begin) / BENCH_OPS;
+}
+
+/**
+ * @brief 随机挑选已添加的定时器，停止后立即重新启动
+ * @param[in] timers 定时器数组
+ * @param[in] count 定时器数量
+ * @return 平均每对停止和启动的ns数
+ */
+static double bench_stop_start(letk_timer_t* timers, uint32_t count)
+{
+    uint64_t begin;
+    uint32_t i;
+    letk_timer_t* pt;
+
+    begin = bench_ns();
+    for (i = 0; i < BENCH_OPS; i++)
+    {
+        pt = &timers[bench_rand() % count];
+        letk_timer_stop(pt);
+        letk_timer_start(pt);
+    }
+    return (double)(bench_ns() - begin) / BENCH_OPS;
+}
+
+#if LETK_TIMER_ENGINE == LETK_TIMER_ENGINE_LIST
+/**
+ * @brief 对照组：单向链表随机移除节点(遍历查找前驱)后添加到头部
+ * @param[in] nodes 节点数组
+ * @param[in] count 节点数量
+ * @return 平均每对移除和添加的ns数
+ */
+static double bench_walk_remove_add(bench_node_t* nodes, uint32_t count)
+{
+    bench_node_t* head = NULL;
+    bench_node_t** pp;
+    bench_node_t* pn;
+    uint64_t begin;
+    uint32_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        nodes[i].next = head;
+        head = &nodes[i];
+    }
+
+    begin = bench_ns();
+    for (i = 0; i < BENCH_OPS; i++)
+    {
+        pn = &nodes[bench_rand() % count];
+        for (pp = &head; *pp != pn; pp = &(*pp)->next)
+        {
+        }
+        *pp = pn->next;
+        pn->next = head;
+        head = pn;
+    }
+    return (double)(bench_ns() - begin) / BENCH_OPS;
+}
+#endif  /* LETK_TIMER_ENGINE == LETK_TIMER_ENGINE_LIST */
+
+/**
+ * @brief 主函数
+ * @return 0
+ */
+int main(void)
+{
+    letk_timer_t* timers;
+#if LETK_TIMER_ENGINE == LETK_TIMER_ENGINE_LIST
+    bench_node_t* nodes;
+#endif  /* LETK_TIMER_ENGINE == LETK_TIMER_ENGINE_LIST */
+    uint32_t n, i, count;
+    double remove_add, stop_start;
+
+    for (n = 0; n < sizeof(bench_sizes) / sizeof(bench_sizes[0]); n++)
+    {
+        count = bench_sizes[n];
+        timers = calloc(count, sizeof(letk_timer_t));
+        if (timers == NULL)
+        {
+            return 1;
+        }
+        for (i = 0; i < count; i++)
+        {
+            letk_timer_init(&timers[i], -1, 1000u + bench_rand() % 100000u, bench_cb, NULL);
+            letk_timer_add(&timers[i]);
+            letk_timer_start(&timers[i]);
+        }
+
+        remove_add = bench_remove_add(timers, count);
+        stop_start = bench_stop_start(timers, count);
+        printf("%-5s timers=%-5lu remove+add=%.1fns stop+start=%.1fns",
+               BENCH_ENGINE_NAME, (unsigned long)count, remove_add, stop_start);
+        letk_timer_remove_all();
+        free(timers);
+
+#if LETK_TIMER_ENGINE == LETK_TIMER_ENGINE_LIST
+        nodes = calloc(count, sizeof(bench_node_t));
+        if (nodes == NULL)
+        {
+            return 1;
+        }
+        printf(" singly-linked-walk=%.1fns", bench_walk_remove_add(nodes, count));
+        free(nodes);
+#endif  /* LETK_TIMER_ENGINE == LETK_TIMER_ENGINE_LIST */
+        printf("\n");
+    }
+    return 0;
+}
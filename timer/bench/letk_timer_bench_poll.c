@@ -0,0 +1,191 @@
+/***********************************************************************************************************************
+** 文件描述：定时器轮询开销基准测试，在主机上比较链表、时间轮和最小堆三种调度引擎
+** 创建作者：付瑞彪(Tom Free)
+** 创建日期：2026年10月18日
+** 编码格式：UTF-8编码
+** 编程语言：C语言，C99标准
+** 缩进格式：4个空格键
+** 命名规范：下划线命名法(小写命名法)
+** 开源许可：MIT许可证，参考：https://mit-license.org
+** 版权信息：Copyright (c) 2013-2022, Tom Free, <tomfreefu@gmail.com>
+**
+** 修改记录
+** 修改日期         修改作者        修改内容
+** 2026年10月18日   付瑞彪          创建文件，初次版本
+**
+***********************************************************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+
+#include "letk_timer.h"
+#include "letk_ticks.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* 默认定时器数量，可由第一个命令行参数指定 */
+#define BENCH_TIMERS_DEFAULT    1000u
+/* 每个场景的轮询次数，每次轮询前推进1ms */
+#define BENCH_POLLS             100000u
+/* 跳过时间场景的跳过时长，模拟无滴答休眠1小时 */
+#define BENCH_SKIP_MS           3600000u
+/* 跳过时间场景的重复次数 */
+#define BENCH_SKIP_ROUNDS       10u
+
+#if LETK_TIMER_ENGINE == LETK_TIMER_ENGINE_LIST
+#define BENCH_ENGINE_NAME       "list"
+#elif LETK_TIMER_ENGINE == LETK_TIMER_ENGINE_WHEEL
+#define BENCH_ENGINE_NAME       "wheel"
+#else
+#define BENCH_ENGINE_NAME       "heap"
+#endif  /* LETK_TIMER_ENGINE */
+
+/* 定时器数组 */
+static letk_timer_t* bench_timers;
+/* 定时器数量 */
+static uint32_t bench_count;
+/* 回调触发次数 */
+static uint32_t bench_fired;
+/* 伪随机数种子，固定初值保证每次运行相同 */
+static uint32_t bench_seed = 1;
+
+/**
+ * @brief 生成伪随机数
+ * @return 伪随机数
+ */
+static uint32_t bench_rand(void)
+{
+    bench_seed = bench_seed * 1103515245u + 12345u;
+    return bench_seed >> 8;
+}
+
+/**
+ * @brief 获取单调时钟的ns时间戳
+ * @return ns时间戳
+ */
+static uint64_t bench_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief 定时器回调，只计数
+ * @param[in] ptimer 定时器指针
+ */
+static void bench_cb(letk_timer_t* ptimer)
+{
+    (void)ptimer;
+    bench_fired++;
+}
+
+/**
+ * @brief 初始化并启动全部定时器，周期在[min, min + span)内随机
+ * @param[in] min 最小周期
+ * @param[in] span 周期范围
+ */
+static void bench_setup(uint32_t min, uint32_t span)
+{
+    uint32_t i;
+
+    letk_timer_remove_all();
+    for (i = 0; i < bench_count; i++)
+    {
+        letk_timer_init(&bench_timers[i], -1, min + bench_rand() % span, bench_cb, NULL);
+        letk_timer_add(&bench_timers[i]);
+        letk_timer_start(&bench_timers[i]);
+    }
+    bench_fired = 0;
+}
+
+/**
+ * @brief 每次推进1ms并轮询，测量平均每次轮询的耗时
+ * @return 平均每次轮询的ns数
+ */
+static double bench_run_polls(void)
+{
+    uint64_t begin;
+    uint32_t i;
+
+    begin = bench_ns();
+    for (i = 0; i < BENCH_POLLS; i++)
+    {
+        letk_ticks_inc_ms(1);
+        letk_timer_poll();
+    }
+    return (double)(bench_ns() - begin) / BENCH_POLLS;
+}
+
+/**
+ * @brief 跳过较长时间后轮询一次，测量这一次轮询的耗时，定时器都还没有到期
+ * @return 各轮中最长的一次轮询ns数
+ */
+static uint64_t bench_run_skip(void)
+{
+    uint64_t begin, cost, worst = 0;
+    uint32_t round, i;
+
+    for (round = 0; round < BENCH_SKIP_ROUNDS; round++)
+    {
+        /* 重新启动，让所有定时器从当前时刻开始计时 */
+        for (i = 0; i < bench_count; i++)
+        {
+            letk_timer_stop(&bench_timers[i]);
+            letk_timer_start(&bench_timers[i]);
+        }
+        letk_timer_poll();
+
+        letk_ticks_skip_ms(BENCH_SKIP_MS);
+        begin = bench_ns();
+        letk_timer_poll();
+        cost = bench_ns() - begin;
+        if (cost > worst)
+        {
+            worst = cost;
+        }
+    }
+    return worst;
+}
+
+/**
+ * @brief 主函数
+ * @param[in] argc 参数数量
+ * @param[in] argv 参数列表，argv[1]为定时器数量
+ * @return 0
+ */
+int main(int argc, char* argv[])
+{
+    double idle, busy;
+    uint64_t skip;
+
+    bench_count = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : BENCH_TIMERS_DEFAULT;
+    if (bench_count == 0)
+    {
+        bench_count = BENCH_TIMERS_DEFAULT;
+    }
+    bench_timers = calloc(bench_count, sizeof(letk_timer_t));
+    if (bench_timers == NULL)
+    {
+        return 1;
+    }
+
+    /* 空闲：所有定时器都远未到期，体现没有到期定时器时的轮询开销 */
+    bench_setup(1000000u, 1000000u);
+    idle = bench_run_polls();
+
+    /* 繁忙：周期10ms到1s，每次轮询都可能有定时器到期 */
+    bench_setup(10u, 990u);
+    busy = bench_run_polls();
+    printf("%-5s timers=%lu idle=%.1fns/poll busy=%.1fns/poll (%lu fired)",
+           BENCH_ENGINE_NAME, (unsigned long)bench_count, idle, busy, (unsigned long)bench_fired);
+
+    /* 跳过：无滴答休眠1小时后的第一次轮询，定时器周期比跳过的时间更长 */
+    bench_setup(2u * BENCH_SKIP_MS, BENCH_SKIP_MS);
+    skip = bench_run_skip();
+    printf(" skip%lums=%.1fus/poll\n", (unsigned long)BENCH_SKIP_MS, (double)skip / 1000.0);
+
+    letk_timer_remove_all();
+    free(bench_timers);
+    return 0;
+}
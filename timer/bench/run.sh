@@ -0,0 +1,14 @@
+#!/bin/sh
+# 在主机上编译并运行定时器基准测试，每个程序分别用三种调度引擎编译
+# 用法：sh timer/bench/run.sh [定时器数量]，编译器由环境变量CC指定，默认cc
+set -e
+cd "$(dirname "$0")"
+CC=${CC:-cc}
+OUT=${TMPDIR:-/tmp}
+for bench in letk_timer_bench_poll letk_timer_bench_churn; do
+    for engine in 0 1 2; do
+        $CC -std=c99 -O2 -Wall -DLETK_TIMER_ENGINE=$engine -I. -I.. -I../../ticks \
+            ../letk_timer.c ../../ticks/letk_ticks.c $bench.c -o "$OUT/${bench}_$engine"
+        "$OUT/${bench}_$engine" "$@"
+    done
+done
@@ -13,12 +13,37 @@
 ** 修改日期         修改作者        修改内容
 ** 2022年5月29日    付瑞彪          创建文件，初次版本
 ** 2022年7月15日    付瑞彪          修改代码注释规范
+** 2026年10月18日   付瑞彪          增加分级时间轮调度引擎
+** 2026年10月18日   付瑞彪          增加最小堆调度引擎
+** 2026年10月18日   付瑞彪          改为双向链表，添加和移除为O(1)
+** 2026年10月18日   付瑞彪          回调中修改链表不再导致轮询从头重新遍历
+** 2026年10月18日   付瑞彪          增加松弛时间，合并触发相近的定时器
+** 2026年10月18日   付瑞彪          增加中断和多线程安全的无锁命令队列
+** 2026年10月18日   付瑞彪          增加回调延迟和执行时间统计
+** 2026年10月18日   付瑞彪          增加周期定时器的超期处理策略
+** 2026年10月18日   付瑞彪          增加基于固定定时器池的一次性和周期调用接口
+** 2026年10月18日   付瑞彪          增加卸载执行，耗时回调可以交给工作线程运行
+** 2026年10月18日   付瑞彪          统计的时间戳默认使用64位us时间戳
+** 2026年10月18日   付瑞彪          增加定时器优先级和限定预算的轮询接口
+** 2026年10月18日   付瑞彪          最小堆改为嵌入定时器的配对堆，不再有容量上限
+** 2026年10月18日   付瑞彪          时间轮长时间未轮询时直接跳到当前时刻，不再逐毫秒推进
+** 2026年10月18日   付瑞彪          统计命令按无符号数打印，超过2^31的值不再显示为负数
+** 2026年10月18日   付瑞彪          最小堆引擎的处理链表改为双向链表，回调中移除的定时器立即断链
 **
 ***********************************************************************************************************************/
 
 #include "letk_timer.h"
 #include "letk_ticks.h"
 #include <stddef.h>
+#if LETK_TIMER_STATS_ENABLE
+#include <string.h>
+#endif  /* LETK_TIMER_STATS_ENABLE */
+#if LETK_TIMER_STATS_CLI_ENABLE
+#include "letk_cli.h"
+#endif  /* LETK_TIMER_STATS_CLI_ENABLE */
+#if (LETK_TIMER_CMD_QUEUE_SIZE > 0) && LETK_TIMER_CMD_QUEUE_MPSC
+#include <stdatomic.h>
+#endif  /* (LETK_TIMER_CMD_QUEUE_SIZE > 0) && LETK_TIMER_CMD_QUEUE_MPSC */
 
 #ifdef __cplusplus
 extern 'C' {
@@ -26,200 +51,1992 @@ extern 'C' {
 
 /* 定时器链表头指针 */
 static letk_timer_t* p_timer_head = NULL;
-/* 标识运行回调期间链表是否发生变化 */
-static bool list_changed = false;
+#if LETK_TIMER_SLACK_ENABLE
+/* 全部定时器中最大的松弛时间，用于限定提前触发的搜索范围 */
+static uint32_t timer_max_slack = 0;
+/* 获取定时器的松弛时间 */
+#define LETK_TIMER_GET_SLACK(pt)    ((pt)->slack)
+#else   /* LETK_TIMER_SLACK_ENABLE */
+#define LETK_TIMER_GET_SLACK(pt)    0u
+#endif  /* LETK_TIMER_SLACK_ENABLE */
+
+#if LETK_TIMER_PRIORITY_LEVELS > 0
+/* 每个优先级一个处理链表 */
+#define LETK_TIMER_RUN_LEVELS       LETK_TIMER_PRIORITY_LEVELS
+/* 获取定时器的优先级 */
+#define LETK_TIMER_GET_PRIO(pt)     ((pt)->priority)
+#else   /* LETK_TIMER_PRIORITY_LEVELS > 0 */
+#define LETK_TIMER_RUN_LEVELS       1u
+#define LETK_TIMER_GET_PRIO(pt)     0u
+#endif  /* LETK_TIMER_PRIORITY_LEVELS > 0 */
+
+#if LETK_TIMER_ENGINE == LETK_TIMER_ENGINE_WHEEL
+/* 时间轮参数 */
+#define LETK_TIMER_WHEEL_SLOTS  (1u << LETK_TIMER_WHEEL_BITS)
+#define LETK_TIMER_WHEEL_MASK   (LETK_TIMER_WHEEL_SLOTS - 1u)
+#define LETK_TIMER_WHEEL_LEVELS ((32u + LETK_TIMER_WHEEL_BITS - 1u) / LETK_TIMER_WHEEL_BITS)
+
+/* 时间轮槽，第N级每个槽跨度为2^(BITS*N)ms，定时器按到期时刻与wheel_time的差值选择级别 */
+static letk_timer_t* wheel_slot[LETK_TIMER_WHEEL_LEVELS][LETK_TIMER_WHEEL_SLOTS];
+/* 已到期等待下一次轮询处理的定时器 */
+static letk_timer_t* wheel_due = NULL;
+/* 本次轮询正在处理的定时器，每个优先级一个链表 */
+static letk_timer_t* wheel_run[LETK_TIMER_RUN_LEVELS];
+/* 时间轮已处理到的时刻 */
+static uint32_t wheel_time;
+/* 时间轮中的定时器数量，包括到期链表 */
+static uint32_t wheel_count = 0;
+/* 时间轮是否已同步到系统时刻 */
+static bool wheel_synced = false;
+
+/**
+ * @brief 插入节点到时间轮槽链表头部
+ * @param[in] pp 槽链表头指针的地址
+ * @param[in] pt 定时器指针
+ */
+static void letk_timer_wheel_link(letk_timer_t** pp, letk_timer_t* pt)
+{
+    pt->wheel_next = *pp;
+    if (pt->wheel_next != NULL)
+    {
+        pt->wheel_next->wheel_pprev = &pt->wheel_next;
+    }
+    pt->wheel_pprev = pp;
+    *pp = pt;
+}
+
+/**
+ * @brief 按到期时刻将定时器放入时间轮
+ * @param[in] pt 定时器指针，必须不在时间轮中
+ */
+static void letk_timer_sched_insert(letk_timer_t* pt)
+{
+    uint32_t delta;
+    uint32_t level;
+
+    if (!wheel_synced)
+    {
+        wheel_time = letk_ticks_get_ms();
+        wheel_synced = true;
+    }
+
+    delta = pt->expire - wheel_time;
+    wheel_count++;
+    if ((int32_t)delta <= 0)
+    {
+        /* 已经到期，下一次轮询处理 */
+        letk_timer_wheel_link(&wheel_due, pt);
+        return;
+    }
+
+    /* 选择能容纳此差值的最低一级 */
+    level = 0;
+    while ((level < LETK_TIMER_WHEEL_LEVELS - 1u) &&
+           ((delta >> (LETK_TIMER_WHEEL_BITS * (level + 1u))) != 0u))
+    {
+        level++;
+    }
+
+    letk_timer_wheel_link(&wheel_slot[level][(pt->expire >> (LETK_TIMER_WHEEL_BITS * level)) & LETK_TIMER_WHEEL_MASK], pt);
+}
+
+/**
+ * @brief 将节点从所在的时间轮槽链表断开
+ * @param[in] pt 定时器指针，必须在时间轮中
+ */
+static void letk_timer_wheel_unlink(letk_timer_t* pt)
+{
+    *pt->wheel_pprev = pt->wheel_next;
+    if (pt->wheel_next != NULL)
+    {
+        pt->wheel_next->wheel_pprev = pt->wheel_pprev;
+    }
+    pt->wheel_next = NULL;
+    pt->wheel_pprev = NULL;
+}
+
+/**
+ * @brief 将定时器从时间轮中移除
+ * @param[in] pt 定时器指针
+ */
+static void letk_timer_sched_erase(letk_timer_t* pt)
+{
+    if (pt->wheel_pprev != NULL)
+    {
+        letk_timer_wheel_unlink(pt);
+        wheel_count--;
+    }
+}
+
+/**
+ * @brief 级联，将上级槽中的定时器重新分配到下级
+ * @note 在第0级槽索引回绕到0时调用，上一级的索引也为0时继续级联更上一级
+ */
+static void letk_timer_wheel_cascade(void)
+{
+    uint32_t level, index;
+    letk_timer_t* pt;
+
+    for (level = 1; level < LETK_TIMER_WHEEL_LEVELS; level++)
+    {
+        index = (wheel_time >> (LETK_TIMER_WHEEL_BITS * level)) & LETK_TIMER_WHEEL_MASK;
+        while ((pt = wheel_slot[level][index]) != NULL)
+        {
+            letk_timer_sched_erase(pt);
+            letk_timer_sched_insert(pt);
+        }
+        if (index != 0)
+        {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief 时间轮直接跳到当前时刻，槽中的定时器全部按新时刻重新放入
+ * @param[in] now 当前时刻
+ * @note 耗时只与槽数和定时器数量有关，与经过的时间无关，已到期的定时器进入到期链表
+ */
+static void letk_timer_wheel_rebase(uint32_t now)
+{
+    letk_timer_t* plist = NULL;
+    letk_timer_t* pt;
+    uint32_t level, index;
+    uint32_t base = wheel_time;
+
+    /* 先全部摘下，借用wheel_next串成临时链表 */
+    for (level = 0; level < LETK_TIMER_WHEEL_LEVELS; level++)
+    {
+        for (index = 0; index < LETK_TIMER_WHEEL_SLOTS; index++)
+        {
+            while ((pt = wheel_slot[level][index]) != NULL)
+            {
+                letk_timer_sched_erase(pt);
+                pt->wheel_next = plist;
+                plist = pt;
+            }
+        }
+    }
+
+    /* 槽中的定时器都晚于原时刻到期，按与原时刻的距离判断是否已到期，经过超过2^31ms也不会误判 */
+    wheel_time = now;
+    while ((pt = plist) != NULL)
+    {
+        plist = pt->wheel_next;
+        pt->wheel_next = NULL;
+        if ((pt->expire - base) <= (now - base))
+        {
+            wheel_count++;
+            letk_timer_wheel_link(&wheel_due, pt);
+        }
+        else
+        {
+            letk_timer_sched_insert(pt);
+        }
+    }
+}
+
+/**
+ * @brief 时间轮推进到当前时刻，到期的槽移入到期链表
+ * @param[in] now 当前时刻
+ * @note 每1ms只访问第0级的一个槽，槽索引回绕时才进行级联；
+ *       经过的时间比重新放入全部定时器的代价还长时(例如无滴答休眠或仿真跳过时间后)，
+ *       直接跳到当前时刻，超过2^31ms没有轮询时也能正确追上
+ */
+static void letk_timer_wheel_advance(uint32_t now)
+{
+    letk_timer_t* pt;
+
+    if (wheel_count == 0)
+    {
+        /* 时间轮为空，直接同步时刻 */
+        wheel_time = now;
+        wheel_synced = true;
+        return;
+    }
+
+    if ((now - wheel_time) > (LETK_TIMER_WHEEL_LEVELS * LETK_TIMER_WHEEL_SLOTS + wheel_count))
+    {
+        letk_timer_wheel_rebase(now);
+        return;
+    }
+
+    while ((int32_t)(now - wheel_time) > 0)
+    {
+        wheel_time++;
+        if ((wheel_time & LETK_TIMER_WHEEL_MASK) == 0)
+        {
+            letk_timer_wheel_cascade();
+        }
+        while ((pt = wheel_slot[0][wheel_time & LETK_TIMER_WHEEL_MASK]) != NULL)
+        {
+            letk_timer_wheel_unlink(pt);
+            letk_timer_wheel_link(&wheel_due, pt);
+        }
+    }
+}
+
+#if LETK_TIMER_SLACK_ENABLE
+/**
+ * @brief 将已到达触发时刻、但还在松弛时间内的定时器提前移入处理链表
+ * @param[in] now 当前时刻
+ * @note 各级只搜索起始时刻在最大松弛时间范围内的槽
+ */
+static void letk_timer_wheel_collect_early(uint32_t now)
+{
+    uint32_t level, k, shift, base;
+    letk_timer_t *pt, *pnext;
+
+    for (level = 0; level < LETK_TIMER_WHEEL_LEVELS; level++)
+    {
+        shift = LETK_TIMER_WHEEL_BITS * level;
+        base = wheel_time >> shift;
+        for (k = 1; k <= LETK_TIMER_WHEEL_SLOTS; k++)
+        {
+            if ((((base + k) << shift) - now) > timer_max_slack)
+            {
+                break;
+            }
+            for (pt = wheel_slot[level][(base + k) & LETK_TIMER_WHEEL_MASK]; pt != NULL; pt = pnext)
+            {
+                pnext = pt->wheel_next;
+                if ((int32_t)(pt->expire - pt->slack - now) <= 0)
+                {
+                    letk_timer_wheel_unlink(pt);
+                    letk_timer_wheel_link(&wheel_run[LETK_TIMER_GET_PRIO(pt)], pt);
+                }
+            }
+        }
+    }
+}
+#endif  /* LETK_TIMER_SLACK_ENABLE */
+
+/**
+ * @brief 判断定时器是否在时间轮中
+ * @param[in] pt 定时器指针
+ * @return 是否在时间轮中
+ */
+static bool letk_timer_sched_contains(const letk_timer_t* pt)
+{
+    return (pt->wheel_pprev != NULL);
+}
+
+/**
+ * @brief 收集到期的定时器到处理链表
+ * @param[in] now 当前时刻
+ * @return 是否有需要处理的定时器
+ * @note 回调中又到期的定时器进入到期链表，留到下一次轮询，与链表引擎一致
+ */
+static bool letk_timer_sched_collect(uint32_t now)
+{
+#if LETK_TIMER_PRIORITY_LEVELS > 0
+    letk_timer_t* pt;
+#endif  /* LETK_TIMER_PRIORITY_LEVELS > 0 */
+
+    letk_timer_wheel_advance(now);
+
+    if (wheel_due == NULL)
+    {
+        return false;
+    }
+#if LETK_TIMER_PRIORITY_LEVELS > 0
+    /* 按优先级分到各处理链表 */
+    while ((pt = wheel_due) != NULL)
+    {
+        letk_timer_wheel_unlink(pt);
+        letk_timer_wheel_link(&wheel_run[pt->priority], pt);
+    }
+#else   /* LETK_TIMER_PRIORITY_LEVELS > 0 */
+    wheel_run[0] = wheel_due;
+    wheel_due = NULL;
+    wheel_run[0]->wheel_pprev = &wheel_run[0];
+#endif  /* LETK_TIMER_PRIORITY_LEVELS > 0 */
+#if LETK_TIMER_SLACK_ENABLE
+    /* 有必须触发的定时器，顺带触发已进入松弛时间的定时器 */
+    if (timer_max_slack > 0)
+    {
+        letk_timer_wheel_collect_early(now);
+    }
+#endif  /* LETK_TIMER_SLACK_ENABLE */
+    return true;
+}
+
+/**
+ * @brief 从处理链表取出一个定时器，优先取高优先级的
+ * @return 定时器指针，NULL表示处理完毕
+ */
+static letk_timer_t* letk_timer_sched_pop_run(void)
+{
+    uint32_t level;
+    letk_timer_t* pt;
+
+    for (level = LETK_TIMER_RUN_LEVELS; level > 0; level--)
+    {
+        pt = wheel_run[level - 1u];
+        if (pt != NULL)
+        {
+            letk_timer_sched_erase(pt);
+            return pt;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 将处理链表中剩余的定时器放回到期链表，留到下一次轮询
+ */
+static void letk_timer_sched_defer_run(void)
+{
+    uint32_t level;
+    letk_timer_t* pt;
+
+    for (level = 0; level < LETK_TIMER_RUN_LEVELS; level++)
+    {
+        while ((pt = wheel_run[level]) != NULL)
+        {
+            letk_timer_wheel_unlink(pt);
+            letk_timer_wheel_link(&wheel_due, pt);
+        }
+    }
+}
+
+/**
+ * @brief 获取最早的到期时刻
+ * @param[out] expire 最早的到期时刻
+ * @return 是否有运行中的定时器
+ * @note 各级从当前槽的下一个槽开始找第一个非空槽，其中最早的就是此级最早的
+ */
+static bool letk_timer_sched_next(uint32_t* expire)
+{
+    uint32_t level, k, shift, cur;
+    const letk_timer_t* pt;
+    bool found = false;
+
+    for (level = 0; level < LETK_TIMER_RUN_LEVELS; level++)
+    {
+        if (wheel_run[level] != NULL)
+        {
+            found = true;
+        }
+    }
+    if ((wheel_due != NULL) || found)
+    {
+        *expire = wheel_time;
+        return true;
+    }
+
+    for (level = 0; level < LETK_TIMER_WHEEL_LEVELS; level++)
+    {
+        shift = LETK_TIMER_WHEEL_BITS * level;
+        cur = (wheel_time >> shift) & LETK_TIMER_WHEEL_MASK;
+        for (k = 1; k <= LETK_TIMER_WHEEL_SLOTS; k++)
+        {
+            pt = wheel_slot[level][(cur + k) & LETK_TIMER_WHEEL_MASK];
+            if (pt == NULL)
+            {
+                continue;
+            }
+            for (; pt != NULL; pt = pt->wheel_next)
+            {
+                if (!found || ((int32_t)(pt->expire - *expire) < 0))
+                {
+                    *expire = pt->expire;
+                    found = true;
+                }
+            }
+            break;
+        }
+    }
+
+    return found;
+}
+#endif  /* LETK_TIMER_ENGINE == LETK_TIMER_ENGINE_WHEEL */
+
+#if LETK_TIMER_ENGINE == LETK_TIMER_ENGINE_HEAP
+/* 定时器在堆中的状态 */
+#define LETK_TIMER_HEAP_NONE    0u          /* 不在堆中 */
+#define LETK_TIMER_HEAP_IN      1u          /* 在堆中 */
+#define LETK_TIMER_HEAP_RUN     2u          /* 已出堆，在本次轮询的处理链表中 */
+
+/* 判断时刻a是否早于时刻b，支持时刻溢出回绕 */
+#define LETK_TIMER_BEFORE(a, b) ((int32_t)((uint32_t)(a) - (uint32_t)(b)) < 0)
+
+/* 按到期时刻排序的配对堆，节点直接嵌在定时器中，容量不受限制，堆顶为最早到期的定时器 */
+static letk_timer_t* heap_root = NULL;
+/* 本次轮询出堆的到期定时器链表，每个优先级一个链表 */
+static letk_timer_t* heap_run[LETK_TIMER_RUN_LEVELS];
+
+/**
+ * @brief 合并两个堆，到期晚的堆顶成为到期早的堆顶的第一个子节点
+ * @param[in] pa 堆顶指针，可以为NULL，不能有兄弟节点
+ * @param[in] pb 堆顶指针，可以为NULL，不能有兄弟节点
+ * @return 合并后的堆顶指针
+ */
+static letk_timer_t* letk_timer_heap_meld(letk_timer_t* pa, letk_timer_t* pb)
+{
+    letk_timer_t* pt;
+
+    if (pa == NULL)
+    {
+        return pb;
+    }
+    if (pb == NULL)
+    {
+        return pa;
+    }
+    if (LETK_TIMER_BEFORE(pb->expire, pa->expire))
+    {
+        pt = pa;
+        pa = pb;
+        pb = pt;
+    }
+
+    pb->heap_sibling = pa->heap_child;
+    if (pb->heap_sibling != NULL)
+    {
+        pb->heap_sibling->heap_prev = pb;
+    }
+    pb->heap_prev = pa;
+    pa->heap_child = pb;
+    return pa;
+}
+
+/**
+ * @brief 两遍合并一串兄弟子堆，先从左到右两两合并，再从右到左逐个合并
+ * @param[in] pfirst 第一个子堆的堆顶指针
+ * @return 合并后的堆顶指针
+ * @note 不使用递归，栈占用固定
+ */
+static letk_timer_t* letk_timer_heap_merge_pairs(letk_timer_t* pfirst)
+{
+    letk_timer_t* pstack = NULL;
+    letk_timer_t* pa;
+    letk_timer_t* pb;
+    letk_timer_t* pnext;
+
+    /* 两两合并，结果借用兄弟指针逆序串起来 */
+    while (pfirst != NULL)
+    {
+        pa = pfirst;
+        pb = pa->heap_sibling;
+        pnext = NULL;
+        if (pb != NULL)
+        {
+            pnext = pb->heap_sibling;
+            pb->heap_sibling = NULL;
+            pb->heap_prev = NULL;
+        }
+        pa->heap_sibling = NULL;
+        pa->heap_prev = NULL;
+        pa = letk_timer_heap_meld(pa, pb);
+        pa->heap_sibling = pstack;
+        pstack = pa;
+        pfirst = pnext;
+    }
+
+    /* 从最后一对开始逐个合并 */
+    while (pstack != NULL)
+    {
+        pnext = pstack->heap_sibling;
+        pstack->heap_sibling = NULL;
+        pfirst = letk_timer_heap_meld(pfirst, pstack);
+        pstack = pnext;
+    }
+    return pfirst;
+}
+
+/**
+ * @brief 按到期时刻将定时器放入堆中
+ * @param[in] pt 定时器指针，必须不在堆中
+ */
+static void letk_timer_sched_insert(letk_timer_t* pt)
+{
+    pt->heap_child = NULL;
+    pt->heap_sibling = NULL;
+    pt->heap_prev = NULL;
+    pt->heap_state = LETK_TIMER_HEAP_IN;
+    heap_root = letk_timer_heap_meld(heap_root, pt);
+}
+
+/**
+ * @brief 将出堆的定时器追加到所属优先级的处理链表尾部
+ * @param[in,out] pp 各优先级处理链表尾指针的地址
+ * @param[in] pt 定时器指针，必须不在堆中
+ */
+static void letk_timer_heap_run_append(letk_timer_t** pp[], letk_timer_t* pt)
+{
+    uint32_t level = LETK_TIMER_GET_PRIO(pt);
+
+    pt->heap_state = LETK_TIMER_HEAP_RUN;
+    pt->heap_pprev = pp[level];
+    *pp[level] = pt;
+    pp[level] = &pt->heap_next;
+}
+
+/**
+ * @brief 将定时器从处理链表中断开
+ * @param[in] pt 定时器指针，必须在处理链表中
+ */
+static void letk_timer_heap_run_unlink(letk_timer_t* pt)
+{
+    *pt->heap_pprev = pt->heap_next;
+    if (pt->heap_next != NULL)
+    {
+        pt->heap_next->heap_pprev = pt->heap_pprev;
+    }
+    pt->heap_next = NULL;
+    pt->heap_pprev = NULL;
+    pt->heap_state = LETK_TIMER_HEAP_NONE;
+}
+
+/**
+ * @brief 将定时器从堆或处理链表中移除
+ * @param[in] pt 定时器指针
+ */
+static void letk_timer_sched_erase(letk_timer_t* pt)
+{
+    letk_timer_t* psub;
+
+    if (pt->heap_state == LETK_TIMER_HEAP_RUN)
+    {
+        /* 在回调中被停止、移除或重新启动，从处理链表断开，之后可以重新初始化 */
+        letk_timer_heap_run_unlink(pt);
+        return;
+    }
+    if (pt->heap_state != LETK_TIMER_HEAP_IN)
+    {
+        return;
+    }
+    pt->heap_state = LETK_TIMER_HEAP_NONE;
+
+    psub = letk_timer_heap_merge_pairs(pt->heap_child);
+    if (pt == heap_root)
+    {
+        heap_root = psub;
+    }
+    else
+    {
+        /* 从父节点或兄弟链中摘下，子树合并后并回堆顶 */
+        if (pt->heap_prev->heap_child == pt)
+        {
+            pt->heap_prev->heap_child = pt->heap_sibling;
+        }
+        else
+        {
+            pt->heap_prev->heap_sibling = pt->heap_sibling;
+        }
+        if (pt->heap_sibling != NULL)
+        {
+            pt->heap_sibling->heap_prev = pt->heap_prev;
+        }
+        heap_root = letk_timer_heap_meld(heap_root, psub);
+    }
+    pt->heap_child = NULL;
+    pt->heap_sibling = NULL;
+    pt->heap_prev = NULL;
+}
+
+#if LETK_TIMER_SLACK_ENABLE
+/**
+ * @brief 获取堆中节点的父节点
+ * @param[in] pt 定时器指针
+ * @return 父节点指针，堆顶返回NULL
+ */
+static letk_timer_t* letk_timer_heap_parent(letk_timer_t* pt)
+{
+    /* 沿兄弟链回到第一个子节点，它的前驱就是父节点 */
+    while ((pt->heap_prev != NULL) && (pt->heap_prev->heap_child != pt))
+    {
+        pt = pt->heap_prev;
+    }
+    return pt->heap_prev;
+}
+
+/**
+ * @brief 搜索已到达触发时刻、但还在松弛时间内的定时器
+ * @param[in] now 当前时刻
+ * @param[in,out] ppp 搜索结果链表尾指针的地址
+ * @note 子节点的最晚到期时刻不早于父节点，超出最大松弛时间范围的节点不再深入其子树，
+ *       不使用递归，栈占用固定
+ */
+static void letk_timer_heap_find_early(uint32_t now, letk_timer_t*** ppp)
+{
+    letk_timer_t* pt = heap_root;
+
+    while (pt != NULL)
+    {
+        if ((pt->expire - now) <= timer_max_slack)
+        {
+            if ((int32_t)(pt->expire - pt->slack - now) <= 0)
+            {
+                **ppp = pt;
+                *ppp = &pt->heap_next;
+            }
+            if (pt->heap_child != NULL)
+            {
+                pt = pt->heap_child;
+                continue;
+            }
+        }
+        /* 子树搜索完毕，转到下一个兄弟，没有则回溯 */
+        while ((pt != NULL) && (pt->heap_sibling == NULL))
+        {
+            pt = letk_timer_heap_parent(pt);
+        }
+        if (pt != NULL)
+        {
+            pt = pt->heap_sibling;
+        }
+    }
+}
+#endif  /* LETK_TIMER_SLACK_ENABLE */
+
+/**
+ * @brief 判断定时器是否在堆中
+ * @param[in] pt 定时器指针
+ * @return 是否在堆中
+ */
+static bool letk_timer_sched_contains(const letk_timer_t* pt)
+{
+    return (pt->heap_state != LETK_TIMER_HEAP_NONE);
+}
+
+/**
+ * @brief 收集到期的定时器到处理链表
+ * @param[in] now 当前时刻
+ * @return 是否有需要处理的定时器
+ * @note 没有到期的定时器时只比较一次堆顶即返回，
+ *       处理期间重新入堆的定时器留到下一次轮询，与链表引擎一致
+ */
+static bool letk_timer_sched_collect(uint32_t now)
+{
+    letk_timer_t** pp[LETK_TIMER_RUN_LEVELS];
+    letk_timer_t* pt;
+    uint32_t level;
+
+    if ((heap_root == NULL) || LETK_TIMER_BEFORE(now, heap_root->expire))
+    {
+        return false;
+    }
+
+    for (level = 0; level < LETK_TIMER_RUN_LEVELS; level++)
+    {
+        pp[level] = &heap_run[level];
+    }
+
+    /* 按到期先后顺序取出全部到期的定时器，追加到各自优先级的链表尾部 */
+    while ((heap_root != NULL) && !LETK_TIMER_BEFORE(now, heap_root->expire))
+    {
+        pt = heap_root;
+        letk_timer_sched_erase(pt);
+        letk_timer_heap_run_append(pp, pt);
+    }
+
+#if LETK_TIMER_SLACK_ENABLE
+    /* 有必须触发的定时器，顺带触发已进入松弛时间的定时器 */
+    if (timer_max_slack > 0)
+    {
+        letk_timer_t* pearly = NULL;
+        letk_timer_t** ptail = &pearly;
+        letk_timer_t* pnext;
+
+        letk_timer_heap_find_early(now, &ptail);
+        *ptail = NULL;
+        for (pt = pearly; pt != NULL; pt = pnext)
+        {
+            pnext = pt->heap_next;
+            letk_timer_sched_erase(pt);
+            letk_timer_heap_run_append(pp, pt);
+        }
+    }
+#endif  /* LETK_TIMER_SLACK_ENABLE */
+
+    for (level = 0; level < LETK_TIMER_RUN_LEVELS; level++)
+    {
+        *pp[level] = NULL;
+    }
+    return true;
+}
+
+/**
+ * @brief 从处理链表取出一个定时器，优先取高优先级的
+ * @return 定时器指针，NULL表示处理完毕
+ */
+static letk_timer_t* letk_timer_sched_pop_run(void)
+{
+    uint32_t level;
+    letk_timer_t* pt;
+
+    /* 在回调中被停止、移除或重新启动的定时器已经断链，链表中只有待处理的定时器 */
+    for (level = LETK_TIMER_RUN_LEVELS; level > 0; level--)
+    {
+        pt = heap_run[level - 1u];
+        if (pt != NULL)
+        {
+            letk_timer_heap_run_unlink(pt);
+            return pt;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 将处理链表中剩余的定时器放回堆中，留到下一次轮询
+ * @note 到期时刻不变，下一次轮询时仍然最先出堆
+ */
+static void letk_timer_sched_defer_run(void)
+{
+    uint32_t level;
+    letk_timer_t* pt;
+
+    for (level = 0; level < LETK_TIMER_RUN_LEVELS; level++)
+    {
+        while ((pt = heap_run[level]) != NULL)
+        {
+            letk_timer_heap_run_unlink(pt);
+            letk_timer_sched_insert(pt);
+        }
+    }
+}
+
+/**
+ * @brief 获取最早的到期时刻
+ * @param[out] expire 最早的到期时刻
+ * @return 是否有运行中的定时器
+ */
+static bool letk_timer_sched_next(uint32_t* expire)
+{
+    uint32_t level;
+
+    for (level = 0; level < LETK_TIMER_RUN_LEVELS; level++)
+    {
+        if (heap_run[level] != NULL)
+        {
+            /* 正在处理到期的定时器 */
+            *expire = heap_run[level]->expire;
+            return true;
+        }
+    }
+    if (heap_root == NULL)
+    {
+        return false;
+    }
+    *expire = heap_root->expire;
+    return true;
+}
+#endif  /* LETK_TIMER_ENGINE == LETK_TIMER_ENGINE_HEAP */
+
+#if LETK_TIMER_ENGINE == LETK_TIMER_ENGINE_LIST
+/* 本次轮询正在处理的定时器，每个优先级一个链表 */
+static letk_timer_t* list_run[LETK_TIMER_RUN_LEVELS];
+
+/**
+ * @brief 将定时器从处理链表中断开
+ * @param[in] pt 定时器指针
+ */
+static void letk_timer_list_run_unlink(letk_timer_t* pt)
+{
+    if (pt->run_pprev == NULL)
+    {
+        return;
+    }
+    *pt->run_pprev = pt->run_next;
+    if (pt->run_next != NULL)
+    {
+        pt->run_next->run_pprev = pt->run_pprev;
+    }
+    pt->run_next = NULL;
+    pt->run_pprev = NULL;
+}
+
+/**
+ * @brief 清空全部处理链表
+ */
+static void letk_timer_list_run_clear(void)
+{
+    uint32_t level;
+
+    for (level = 0; level < LETK_TIMER_RUN_LEVELS; level++)
+    {
+        while (list_run[level] != NULL)
+        {
+            letk_timer_list_run_unlink(list_run[level]);
+        }
+    }
+}
+
+/**
+ * @brief 遍历一遍链表，将到期的定时器按优先级追加到处理链表尾部
+ * @return 是否有需要处理的定时器
+ */
+static bool letk_timer_list_collect(void)
+{
+    letk_timer_t** pp[LETK_TIMER_RUN_LEVELS];
+    letk_timer_t* pt;
+    uint32_t level;
+    bool found = false;
+#if LETK_TIMER_SLACK_ENABLE
+    /* 没有松弛时间时，到期的定时器都必须触发 */
+    bool must = (timer_max_slack == 0);
+#endif  /* LETK_TIMER_SLACK_ENABLE */
+
+    for (level = 0; level < LETK_TIMER_RUN_LEVELS; level++)
+    {
+        pp[level] = &list_run[level];
+    }
+
+    for (pt = p_timer_head; pt != NULL; pt = pt->next)
+    {
+        if (pt->status && pt->repeat && letk_ticks_is_timeout(pt->last, pt->interval))
+        {
+            level = LETK_TIMER_GET_PRIO(pt);
+            pt->run_next = NULL;
+            pt->run_pprev = pp[level];
+            *pp[level] = pt;
+            pp[level] = &pt->run_next;
+            found = true;
+#if LETK_TIMER_SLACK_ENABLE
+            if (!must && letk_ticks_is_timeout(pt->last, pt->interval + pt->slack))
+            {
+                must = true;
+            }
+#endif  /* LETK_TIMER_SLACK_ENABLE */
+        }
+    }
+
+#if LETK_TIMER_SLACK_ENABLE
+    /* 只有存在必须触发的定时器时，才顺带触发已进入松弛时间的定时器 */
+    if (found && !must)
+    {
+        letk_timer_list_run_clear();
+        found = false;
+    }
+#endif  /* LETK_TIMER_SLACK_ENABLE */
+    return found;
+}
+
+/**
+ * @brief 从处理链表取出一个定时器，优先取高优先级的
+ * @return 定时器指针，NULL表示处理完毕
+ */
+static letk_timer_t* letk_timer_list_pop_run(void)
+{
+    uint32_t level;
+    letk_timer_t* pt;
+
+    for (level = LETK_TIMER_RUN_LEVELS; level > 0; level--)
+    {
+        pt = list_run[level - 1u];
+        if (pt != NULL)
+        {
+            letk_timer_list_run_unlink(pt);
+            return pt;
+        }
+    }
+    return NULL;
+}
+#endif  /* LETK_TIMER_ENGINE == LETK_TIMER_ENGINE_LIST */
+
+#if LETK_TIMER_ENGINE != LETK_TIMER_ENGINE_LIST
+/**
+ * @brief 重新调度定时器，已添加、已启动且未运行结束的定时器按到期时刻放入调度引擎
+ * @param[in] pt 定时器指针
+ */
+static void letk_timer_reschedule(letk_timer_t* pt)
+{
+    letk_timer_sched_erase(pt);
+    if (pt->linked && pt->status && pt->repeat)
+    {
+        /* 按最晚到期时刻调度 */
+        pt->expire = pt->last + pt->interval + LETK_TIMER_GET_SLACK(pt);
+        letk_timer_sched_insert(pt);
+    }
+}
+#endif  /* LETK_TIMER_ENGINE != LETK_TIMER_ENGINE_LIST */
+
+#if LETK_TIMER_STATS_ENABLE
+/* 统计用的高精度时间戳钩子 */
+static letk_timer_clock_cb_t* timer_clock_cb = NULL;
+
+/**
+ * @brief 读取统计用的时间戳
+ * @return 时间戳
+ */
+static uint32_t letk_timer_clock(void)
+{
+    return (timer_clock_cb != NULL) ? timer_clock_cb() : (uint32_t)letk_ticks_get_us64();
+}
+
+/**
+ * @brief 记录一次触发
+ * @param[in] pt 定时器指针
+ * @param[in] late 触发延迟
+ * @param[in] run 回调执行时间
+ */
+static void letk_timer_stats_update(letk_timer_t* pt, uint32_t late, uint32_t run)
+{
+    letk_timer_stats_t* ps = &pt->stats;
+
+    ps->count++;
+    ps->late_total += late;
+    if (late > ps->late_max)
+    {
+        ps->late_max = late;
+    }
+    ps->run_total += run;
+    if (run < ps->run_min)
+    {
+        ps->run_min = run;
+    }
+    if (run > ps->run_max)
+    {
+        ps->run_max = run;
+    }
+}
+#endif  /* LETK_TIMER_STATS_ENABLE */
+
+#if LETK_TIMER_OFFLOAD_ENABLE
+/* 卸载执行钩子 */
+static letk_timer_offload_cb_t* timer_offload_cb = NULL;
+#endif  /* LETK_TIMER_OFFLOAD_ENABLE */
+
+/**
+ * @brief 运行定时器回调，标记为卸载执行的交给卸载执行钩子
+ * @param[in] pt 定时器指针
+ */
+static void letk_timer_invoke(letk_timer_t* pt)
+{
+#if LETK_TIMER_OFFLOAD_ENABLE
+    if (pt->offload && (timer_offload_cb != NULL))
+    {
+        timer_offload_cb(pt);
+        return;
+    }
+#endif  /* LETK_TIMER_OFFLOAD_ENABLE */
+    pt->cb(pt);
+}
+
+/**
+ * @brief 定时器到期处理，倒计数、更新起始时间并运行回调
+ * @param[in] pt 定时器指针
+ */
+static void letk_timer_fire(letk_timer_t* pt)
+{
+#if LETK_TIMER_STATS_ENABLE || LETK_TIMER_OVERRUN_ENABLE
+    /* 经过时间减去周期即为触发延迟，按无符号比较，超过2^31ms的延迟也能正确计算 */
+    uint32_t late = letk_ticks_get_ms() - pt->last;
+#endif  /* LETK_TIMER_STATS_ENABLE || LETK_TIMER_OVERRUN_ENABLE */
+#if LETK_TIMER_STATS_ENABLE
+    uint32_t begin;
+#endif  /* LETK_TIMER_STATS_ENABLE */
+
+#if LETK_TIMER_STATS_ENABLE || LETK_TIMER_OVERRUN_ENABLE
+    /* 松弛时间内提前触发时没有延迟 */
+    late = (late > pt->interval) ? (late - pt->interval) : 0u;
+#endif  /* LETK_TIMER_STATS_ENABLE || LETK_TIMER_OVERRUN_ENABLE */
+
+    /* 进行倒计数 */
+    if (pt->repeat > 0)
+    {
+        --pt->repeat;
+    }
+    /* 重置起始时间 */
+    pt->last = pt->last + pt->interval;
+#if LETK_TIMER_OVERRUN_ENABLE
+    pt->missed = 0;
+    if ((pt->overrun != LETK_TIMER_OVERRUN_CATCH_UP) &&
+        (pt->interval > 0) && (late >= pt->interval))
+    {
+        /* 错过的周期不再补触发，起始时间对齐到当前时刻之前最近的周期点 */
+        if (pt->overrun == LETK_TIMER_OVERRUN_REPORT)
+        {
+            pt->missed = late / pt->interval;
+        }
+        pt->last += (late / pt->interval) * pt->interval;
+    }
+#endif  /* LETK_TIMER_OVERRUN_ENABLE */
+    /* 运行回调 */
+    if (pt->cb != NULL)
+    {
+#if LETK_TIMER_STATS_ENABLE
+        begin = letk_timer_clock();
+        letk_timer_invoke(pt);
+        letk_timer_stats_update(pt, late, letk_timer_clock() - begin);
+#else
+        letk_timer_invoke(pt);
+#endif  /* LETK_TIMER_STATS_ENABLE */
+    }
+}
+
+/**
+ * @brief 从指定时刻启动定时器
+ * @param[in] pt 定时器指针
+ * @param[in] ms 起始时刻
+ */
+static void letk_timer_start_at(letk_timer_t* pt, uint32_t ms)
+{
+    /* 切换为运行态 */
+    pt->status = 1;
+    /* 保存起始ticks */
+    pt->last = ms;
+#if LETK_TIMER_ENGINE != LETK_TIMER_ENGINE_LIST
+    letk_timer_reschedule(pt);
+#endif  /* LETK_TIMER_ENGINE != LETK_TIMER_ENGINE_LIST */
+}
+
+#if LETK_TIMER_POOL_SIZE > 0
+/* 动态定时器池节点 */
+typedef struct _letk_timer_node_t letk_timer_node_t;
+struct _letk_timer_node_t
+{
+    letk_timer_t timer;             /* 定时器，必须是第一个成员 */
+    letk_timer_call_cb_t* cb;       /* 用户回调函数 */
+    letk_timer_node_t* free_next;   /* 空闲链表下一个节点指针 */
+    uint16_t gen;                   /* 代数，每次释放加1，防止取消已被重新分配的节点 */
+    uint8_t used;                   /* 是否已分配 */
+};
+
+/* 动态定时器池 */
+static letk_timer_node_t timer_pool[LETK_TIMER_POOL_SIZE];
+/* 从未分配过的节点起始位置，免去初始化 */
+static uint16_t pool_top = 0;
+/* 已释放节点的空闲链表 */
+static letk_timer_node_t* pool_free = NULL;
+
+/**
+ * @brief 从定时器池分配节点
+ * @return 节点指针，NULL表示定时器池已满
+ */
+static letk_timer_node_t* letk_timer_pool_alloc(void)
+{
+    letk_timer_node_t* pn = pool_free;
+
+    if (pn != NULL)
+    {
+        pool_free = pn->free_next;
+    }
+    else if (pool_top < LETK_TIMER_POOL_SIZE)
+    {
+        pn = &timer_pool[pool_top++];
+    }
+    return pn;
+}
+
+/**
+ * @brief 释放节点到定时器池
+ * @param[in] pn 节点指针
+ */
+static void letk_timer_pool_free(letk_timer_node_t* pn)
+{
+    letk_timer_remove(&pn->timer);
+    pn->used = 0;
+    pn->gen++;
+    pn->free_next = pool_free;
+    pool_free = pn;
+}
+
+/**
+ * @brief 清空定时器池，定时器已全部从链表移除
+ */
+static void letk_timer_pool_reset(void)
+{
+    uint16_t i;
+
+    for (i = 0; i < pool_top; i++)
+    {
+        if (timer_pool[i].used)
+        {
+            timer_pool[i].used = 0;
+            timer_pool[i].gen++;
+        }
+    }
+    pool_top = 0;
+    pool_free = NULL;
+}
+
+/**
+ * @brief 动态定时器的回调，转调用户回调，单次定时器触发后自动释放
+ * @param[in] pt 定时器指针
+ */
+static void letk_timer_pool_cb(letk_timer_t* pt)
+{
+    letk_timer_node_t* pn = (letk_timer_node_t*)pt;
+    letk_timer_call_cb_t* cb = pn->cb;
+    void* arg = pt->user_data;
+
+    /* 单次定时器先释放，用户回调中可以立即重新分配 */
+    if (pt->repeat == 0)
+    {
+        letk_timer_pool_free(pn);
+    }
+    cb(arg);
+}
+#endif  /* LETK_TIMER_POOL_SIZE > 0 */
+
+/**
+ * @brief 初始化定时器参数
+ * @param[in] ptimer 定时器指针
+ * @param[in] repeat >0：运行次数，0：运行结束，<0：无限循环
+ * @param[in] interval 空闲间隔时间
+ * @param[in] cb 回调函数
+ * @param[in] user_data 用户数据指针
+ */
+void letk_timer_init(letk_timer_t* ptimer,
+                     int32_t repeat,
+                     uint32_t interval,
+                     letk_timer_cb_t *cb,
+                     void* user_data)
+{
+    if (ptimer != NULL)
+    {
+        ptimer->next = NULL;
+        ptimer->prev = NULL;
+        ptimer->linked = 0;
+#if LETK_TIMER_SLACK_ENABLE
+        ptimer->slack = 0;
+#endif  /* LETK_TIMER_SLACK_ENABLE */
+#if LETK_TIMER_OVERRUN_ENABLE
+        ptimer->missed = 0;
+        ptimer->overrun = LETK_TIMER_OVERRUN_CATCH_UP;
+#endif  /* LETK_TIMER_OVERRUN_ENABLE */
+#if LETK_TIMER_PRIORITY_LEVELS > 0
+        ptimer->priority = 0;
+#endif  /* LETK_TIMER_PRIORITY_LEVELS > 0 */
+#if LETK_TIMER_OFFLOAD_ENABLE
+        ptimer->offload = 0;
+#endif  /* LETK_TIMER_OFFLOAD_ENABLE */
+#if LETK_TIMER_STATS_ENABLE
+        ptimer->name = NULL;
+        letk_timer_reset_stats(ptimer);
+#endif  /* LETK_TIMER_STATS_ENABLE */
+        ptimer->repeat = repeat;
+        ptimer->interval = interval;
+        ptimer->status = 0;
+        ptimer->cb = cb;
+        ptimer->user_data = user_data;
+#if LETK_TIMER_ENGINE == LETK_TIMER_ENGINE_LIST
+        ptimer->run_next = NULL;
+        ptimer->run_pprev = NULL;
+#elif LETK_TIMER_ENGINE == LETK_TIMER_ENGINE_WHEEL
+        ptimer->wheel_next = NULL;
+        ptimer->wheel_pprev = NULL;
+#elif LETK_TIMER_ENGINE == LETK_TIMER_ENGINE_HEAP
+        ptimer->heap_next = NULL;
+        ptimer->heap_pprev = NULL;
+        ptimer->heap_child = NULL;
+        ptimer->heap_sibling = NULL;
+        ptimer->heap_prev = NULL;
+        ptimer->heap_state = LETK_TIMER_HEAP_NONE;
+#endif  /* LETK_TIMER_ENGINE */
+    }
+}
+
+/**
+ * @brief 添加定时器到链表
+ * @param[in] ptimer 待添加的定时器指针
+ */
+void letk_timer_add(letk_timer_t* ptimer)
+{
+    if ((ptimer == NULL) || ptimer->linked)
+    {
+        /* 已存在 */
+        return;
+    }
+
+    /* 添加到链表头部 */
+    ptimer->prev = NULL;
+    ptimer->next = p_timer_head;
+    if (p_timer_head != NULL)
+    {
+        p_timer_head->prev = ptimer;
+    }
+    p_timer_head = ptimer;
+    ptimer->linked = 1;
+
+#if LETK_TIMER_ENGINE != LETK_TIMER_ENGINE_LIST
+    /* 已启动的定时器放入调度引擎 */
+    letk_timer_reschedule(ptimer);
+#endif  /* LETK_TIMER_ENGINE != LETK_TIMER_ENGINE_LIST */
+}
+
+/**
+ * @brief 从链表移除定时器
+ * @param[in] ptimer 待移除的定时器指针
+ */
+void letk_timer_remove(letk_timer_t* ptimer)
+{
+    if ((ptimer == NULL) || !ptimer->linked)
+    {
+        return;
+    }
+
+    /* 断链 */
+    if (ptimer->prev != NULL)
+    {
+        ptimer->prev->next = ptimer->next;
+    }
+    else
+    {
+        p_timer_head = ptimer->next;
+    }
+    if (ptimer->next != NULL)
+    {
+        ptimer->next->prev = ptimer->prev;
+    }
+    /* 释放指针，防止别人摆弄 */
+    ptimer->next = NULL;
+    ptimer->prev = NULL;
+    ptimer->linked = 0;
+
+#if LETK_TIMER_ENGINE != LETK_TIMER_ENGINE_LIST
+    letk_timer_sched_erase(ptimer);
+#else   /* LETK_TIMER_ENGINE != LETK_TIMER_ENGINE_LIST */
+    /* 在回调中被移除，从处理链表断开，之后可以重新初始化 */
+    letk_timer_list_run_unlink(ptimer);
+#endif  /* LETK_TIMER_ENGINE != LETK_TIMER_ENGINE_LIST */
+}
+
+/**
+ * @brief 移除全部的定时器
+ */
+void letk_timer_remove_all(void)
+{
+    letk_timer_t *ptemp = p_timer_head;
+    letk_timer_t *pnext = ptemp;
+
+    while (ptemp != NULL)
+    {
+        /* 备份下一个 */
+        pnext = ptemp->next;
+        /* 释放指针，防止别人摆弄 */
+        ptemp->next = NULL;
+        ptemp->prev = NULL;
+        ptemp->linked = 0;
+#if LETK_TIMER_ENGINE != LETK_TIMER_ENGINE_LIST
+        letk_timer_sched_erase(ptemp);
+#else   /* LETK_TIMER_ENGINE != LETK_TIMER_ENGINE_LIST */
+        letk_timer_list_run_unlink(ptemp);
+#endif  /* LETK_TIMER_ENGINE != LETK_TIMER_ENGINE_LIST */
+        /* 移到下一个 */
+        ptemp = pnext;
+    }
+
+#if LETK_TIMER_POOL_SIZE > 0
+    letk_timer_pool_reset();
+#endif  /* LETK_TIMER_POOL_SIZE > 0 */
+
+    /* 头节点为空 */
+    p_timer_head = NULL;
+}
+
+#if LETK_TIMER_SLACK_ENABLE
+/**
+ * @brief 设置定时器的松弛时间
+ * @param[in] ptimer 定时器指针
+ * @param[in] slack 松弛时间，到期后最多可延后的ms数，0表示准时触发
+ */
+void letk_timer_set_slack(letk_timer_t* ptimer, uint32_t slack)
+{
+    if (ptimer != NULL)
+    {
+        ptimer->slack = slack;
+        if (slack > timer_max_slack)
+        {
+            timer_max_slack = slack;
+        }
+    }
+}
+#endif  /* LETK_TIMER_SLACK_ENABLE */
+
+#if LETK_TIMER_OVERRUN_ENABLE
+/**
+ * @brief 设置定时器的超期处理策略
+ * @param[in] ptimer 定时器指针
+ * @param[in] policy 超期处理策略，LETK_TIMER_OVERRUN_XXX
+ */
+void letk_timer_set_overrun(letk_timer_t* ptimer, uint8_t policy)
+{
+    if (ptimer != NULL)
+    {
+        ptimer->overrun = policy;
+    }
+}
+
+/**
+ * @brief 获取本次触发前错过的周期数，在回调中调用
+ * @param[in] ptimer 定时器指针(必须非NULL)
+ * @return 错过的周期数
+ */
+uint32_t letk_timer_get_missed(const letk_timer_t* ptimer)
+{
+    return ptimer->missed;
+}
+#endif  /* LETK_TIMER_OVERRUN_ENABLE */
+
+#if LETK_TIMER_PRIORITY_LEVELS > 0
+/**
+ * @brief 设置定时器的优先级
+ * @param[in] ptimer 定时器指针
+ * @param[in] priority 优先级，数值越大越优先
+ */
+void letk_timer_set_priority(letk_timer_t* ptimer, uint8_t priority)
+{
+    if (ptimer != NULL)
+    {
+#if LETK_TIMER_PRIORITY_LEVELS < 256
+        if (priority >= LETK_TIMER_PRIORITY_LEVELS)
+        {
+            /* 超出范围按最高优先级处理 */
+            priority = (uint8_t)(LETK_TIMER_PRIORITY_LEVELS - 1u);
+        }
+#endif  /* LETK_TIMER_PRIORITY_LEVELS < 256 */
+        ptimer->priority = priority;
+    }
+}
+#endif  /* LETK_TIMER_PRIORITY_LEVELS > 0 */
+
+/**
+ * @brief 启动定时器
+ * @param[in] ptimer 定时器指针
+ */
+void letk_timer_start(letk_timer_t* ptimer)
+{
+    if (ptimer != NULL)
+    {
+        letk_timer_start_at(ptimer, letk_ticks_get_ms());
+    }
+}
 
 /**
- * @brief 初始化定时器参数
+ * @brief 停止定时器
  * @param[in] ptimer 定时器指针
- * @param[in] repeat >0：运行次数，0：运行结束，<0：无限循环
- * @param[in] interval 空闲间隔时间
- * @param[in] cb 回调函数
- * @param[in] user_data 用户数据指针
  */
-void letk_timer_init(letk_timer_t* ptimer,
-                     int32_t repeat,
-                     uint32_t interval,
-                     letk_timer_cb_t *cb,
-                     void* user_data)
+void letk_timer_stop(letk_timer_t* ptimer)
 {
     if (ptimer != NULL)
     {
-        ptimer->next = NULL;
-        ptimer->repeat = repeat;
-        ptimer->interval = interval;
+        /* 切换为挂起态 */
         ptimer->status = 0;
-        ptimer->cb = cb;
-        ptimer->user_data = user_data;
+#if LETK_TIMER_ENGINE != LETK_TIMER_ENGINE_LIST
+        letk_timer_sched_erase(ptimer);
+#endif  /* LETK_TIMER_ENGINE != LETK_TIMER_ENGINE_LIST */
     }
 }
 
+#if LETK_TIMER_POOL_SIZE > 0
 /**
- * @brief 添加定时器到链表
- * @param[in] ptimer 待添加的定时器指针
+ * @brief 从定时器池分配定时器并启动
+ * @param[in] ms 间隔ms数
+ * @param[in] repeat >0：运行次数，<0：无限循环
+ * @param[in] cb 回调函数
+ * @param[in] arg 回调参数
+ * @return 定时器ID，失败返回LETK_TIMER_ID_NONE
  */
-void letk_timer_add(letk_timer_t* ptimer)
+static letk_timer_id_t letk_timer_call(uint32_t ms, int32_t repeat, letk_timer_call_cb_t* cb, void* arg)
+{
+    letk_timer_node_t* pn;
+
+    if (cb == NULL)
+    {
+        return LETK_TIMER_ID_NONE;
+    }
+    pn = letk_timer_pool_alloc();
+    if (pn == NULL)
+    {
+        return LETK_TIMER_ID_NONE;
+    }
+
+    pn->cb = cb;
+    pn->used = 1;
+    letk_timer_init(&pn->timer, repeat, ms, letk_timer_pool_cb, arg);
+    letk_timer_add(&pn->timer);
+    letk_timer_start(&pn->timer);
+
+    /* 高16位为代数，低16位为下标加1，保证ID不为0 */
+    return ((letk_timer_id_t)pn->gen << 16) | (letk_timer_id_t)(pn - timer_pool + 1);
+}
+
+/**
+ * @brief 延时调用，触发后自动释放
+ * @param[in] ms 延时ms数
+ * @param[in] cb 回调函数
+ * @param[in] arg 回调参数
+ * @return 定时器ID，失败返回LETK_TIMER_ID_NONE
+ */
+letk_timer_id_t letk_timer_call_after(uint32_t ms, letk_timer_call_cb_t* cb, void* arg)
+{
+    return letk_timer_call(ms, 1, cb, arg);
+}
+
+/**
+ * @brief 周期调用，取消后释放
+ * @param[in] ms 周期ms数
+ * @param[in] cb 回调函数
+ * @param[in] arg 回调参数
+ * @return 定时器ID，失败返回LETK_TIMER_ID_NONE
+ */
+letk_timer_id_t letk_timer_call_every(uint32_t ms, letk_timer_call_cb_t* cb, void* arg)
+{
+    return letk_timer_call(ms, -1, cb, arg);
+}
+
+/**
+ * @brief 取消延时调用或周期调用，并释放定时器
+ * @param[in] id 定时器ID
+ * @return 是否成功
+ */
+bool letk_timer_cancel(letk_timer_id_t id)
+{
+    uint32_t index = (id & 0xFFFFu) - 1u;
+    letk_timer_node_t* pn;
+
+    if (index >= LETK_TIMER_POOL_SIZE)
+    {
+        return false;
+    }
+    pn = &timer_pool[index];
+    if (!pn->used || (pn->gen != (uint16_t)(id >> 16)))
+    {
+        return false;
+    }
+    letk_timer_pool_free(pn);
+    return true;
+}
+#endif  /* LETK_TIMER_POOL_SIZE > 0 */
+
+#if LETK_TIMER_CMD_QUEUE_SIZE > 0
+/* 命令类型 */
+enum
+{
+    LETK_TIMER_CMD_START,       /* 启动，已在运行则忽略 */
+    LETK_TIMER_CMD_RESTART,     /* 重新启动 */
+    LETK_TIMER_CMD_STOP,        /* 停止 */
+};
+
+/* 命令队列掩码 */
+#define LETK_TIMER_CMD_QUEUE_MASK   (LETK_TIMER_CMD_QUEUE_SIZE - 1u)
+
+#if LETK_TIMER_CMD_QUEUE_MPSC
+/* 命令单元，seq为序号相对单元下标的偏移，静态清零即为初始状态 */
+typedef struct
+{
+    atomic_uint seq;            /* 序号偏移，用于生产者之间和生产者与消费者之间同步 */
+    letk_timer_t* ptimer;       /* 定时器指针 */
+    uint32_t ms;                /* 命令发出的时刻 */
+    uint8_t cmd;                /* 命令类型 */
+} letk_timer_cmd_t;
+
+/* 命令队列 */
+static letk_timer_cmd_t cmd_queue[LETK_TIMER_CMD_QUEUE_SIZE];
+/* 生产者写位置 */
+static atomic_uint cmd_head;
+/* 消费者读位置，只在letk_timer_poll中访问 */
+static unsigned int cmd_tail = 0;
+
+/**
+ * @brief 放入一条命令，多生产者无锁
+ * @param[in] ptimer 定时器指针
+ * @param[in] cmd 命令类型
+ * @return 是否成功，队列满时返回false
+ */
+static bool letk_timer_cmd_push(letk_timer_t* ptimer, uint8_t cmd)
 {
-    const letk_timer_t* pt = p_timer_head;
+    unsigned int pos, index;
+    int diff;
+    letk_timer_cmd_t* pc;
 
     if (ptimer == NULL)
     {
-        return;
+        return false;
     }
 
-    /* 搜索是否已经存在于链表中 */
-    while (pt != NULL)
+    pos = atomic_load_explicit(&cmd_head, memory_order_relaxed);
+    for (;;)
     {
-        if (pt == ptimer)
+        index = pos & LETK_TIMER_CMD_QUEUE_MASK;
+        pc = &cmd_queue[index];
+        diff = (int)(index + atomic_load_explicit(&pc->seq, memory_order_acquire) - pos);
+        if (diff == 0)
+        {
+            /* 单元空闲，抢占写位置 */
+            if (atomic_compare_exchange_weak_explicit(&cmd_head, &pos, pos + 1u,
+                                                      memory_order_relaxed, memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            /* 队列已满 */
+            return false;
+        }
+        else
         {
-            /* 已存在 */
-            return;
+            /* 被其他生产者抢先，重新读取写位置 */
+            pos = atomic_load_explicit(&cmd_head, memory_order_relaxed);
         }
-        pt = pt->next;
     }
 
-    /* 添加到链表头部 */
-    ptimer->next = p_timer_head;
-    p_timer_head = ptimer;
-
-    list_changed = true;
+    pc->ptimer = ptimer;
+    pc->ms = letk_ticks_get_ms();
+    pc->cmd = cmd;
+    /* 发布命令 */
+    atomic_store_explicit(&pc->seq, pos + 1u - index, memory_order_release);
+    return true;
 }
 
 /**
- * @brief 从链表移除定时器
- * @param[in] ptimer 待移除的定时器指针
+ * @brief 取出一条命令，只在letk_timer_poll中调用
+ * @param[out] pcmd 命令存储
+ * @return 是否取到命令
  */
-void letk_timer_remove(letk_timer_t* ptimer)
+static bool letk_timer_cmd_pop(letk_timer_cmd_t* pcmd)
 {
-    letk_timer_t* pt;
+    unsigned int index = cmd_tail & LETK_TIMER_CMD_QUEUE_MASK;
+    letk_timer_cmd_t* pc = &cmd_queue[index];
 
-    if ((ptimer == NULL) || (p_timer_head == NULL))
+    if ((index + atomic_load_explicit(&pc->seq, memory_order_acquire)) != (cmd_tail + 1u))
     {
-        return;
+        /* 队列为空或生产者还未写完 */
+        return false;
     }
 
-    /* 判断是否是链表头节点 */
-    if (p_timer_head == ptimer)
+    pcmd->ptimer = pc->ptimer;
+    pcmd->ms = pc->ms;
+    pcmd->cmd = pc->cmd;
+    /* 释放单元给下一轮的生产者 */
+    atomic_store_explicit(&pc->seq, cmd_tail + LETK_TIMER_CMD_QUEUE_SIZE - index, memory_order_release);
+    cmd_tail++;
+    return true;
+}
+
+/**
+ * @brief 判断命令队列是否为空
+ * @return 是否为空
+ */
+static bool letk_timer_cmd_empty(void)
+{
+    return (atomic_load_explicit(&cmd_head, memory_order_acquire) == cmd_tail);
+}
+#else   /* LETK_TIMER_CMD_QUEUE_MPSC */
+/* 命令单元 */
+typedef struct
+{
+    letk_timer_t* ptimer;       /* 定时器指针 */
+    uint32_t ms;                /* 命令发出的时刻 */
+    uint8_t cmd;                /* 命令类型 */
+} letk_timer_cmd_t;
+
+/* 命令队列，单生产者单消费者，生产者只写head，消费者只写tail，
+ * 必须加volatile关键字，保证单元写完之后才更新head */
+static volatile letk_timer_cmd_t cmd_queue[LETK_TIMER_CMD_QUEUE_SIZE];
+/* 生产者写位置 */
+static volatile uint32_t cmd_head = 0;
+/* 消费者读位置 */
+static volatile uint32_t cmd_tail = 0;
+
+/**
+ * @brief 放入一条命令，单生产者无锁
+ * @param[in] ptimer 定时器指针
+ * @param[in] cmd 命令类型
+ * @return 是否成功，队列满时返回false
+ */
+static bool letk_timer_cmd_push(letk_timer_t* ptimer, uint8_t cmd)
+{
+    uint32_t head = cmd_head;
+    volatile letk_timer_cmd_t* pc;
+
+    if ((ptimer == NULL) || ((head - cmd_tail) >= LETK_TIMER_CMD_QUEUE_SIZE))
     {
-        /* 头直接指向下一个 */
-        p_timer_head = p_timer_head->next;
-        /* 释放指针，防止别人摆弄 */
-        ptimer->next = NULL;
+        return false;
+    }
 
-        list_changed = true;
-        return;
+    pc = &cmd_queue[head & LETK_TIMER_CMD_QUEUE_MASK];
+    pc->ptimer = ptimer;
+    pc->ms = letk_ticks_get_ms();
+    pc->cmd = cmd;
+    /* 发布命令 */
+    cmd_head = head + 1u;
+    return true;
+}
+
+/**
+ * @brief 取出一条命令，只在letk_timer_poll中调用
+ * @param[out] pcmd 命令存储
+ * @return 是否取到命令
+ */
+static bool letk_timer_cmd_pop(letk_timer_cmd_t* pcmd)
+{
+    uint32_t tail = cmd_tail;
+    volatile letk_timer_cmd_t* pc;
+
+    if (tail == cmd_head)
+    {
+        return false;
     }
 
-    /* 搜索链表中timer位置的前一个 */
-    pt = p_timer_head;
-    while (pt != NULL)
+    pc = &cmd_queue[tail & LETK_TIMER_CMD_QUEUE_MASK];
+    pcmd->ptimer = pc->ptimer;
+    pcmd->ms = pc->ms;
+    pcmd->cmd = pc->cmd;
+    /* 释放单元 */
+    cmd_tail = tail + 1u;
+    return true;
+}
+
+/**
+ * @brief 判断命令队列是否为空
+ * @return 是否为空
+ */
+static bool letk_timer_cmd_empty(void)
+{
+    return (cmd_head == cmd_tail);
+}
+#endif  /* LETK_TIMER_CMD_QUEUE_MPSC */
+
+/**
+ * @brief 执行命令队列中的全部命令
+ */
+static void letk_timer_cmd_drain(void)
+{
+    letk_timer_cmd_t cmd;
+
+    while (letk_timer_cmd_pop(&cmd))
     {
-        if (pt->next == ptimer)
+        switch (cmd.cmd)
         {
-            /* 断链 */
-            pt->next = ptimer->next;
-            /* 释放指针，防止别人摆弄 */
-            ptimer->next = NULL;
-
-            list_changed = true;
-            return;
+        case LETK_TIMER_CMD_START:
+            if (!cmd.ptimer->status)
+            {
+                letk_timer_start_at(cmd.ptimer, cmd.ms);
+            }
+            break;
+        case LETK_TIMER_CMD_RESTART:
+            letk_timer_start_at(cmd.ptimer, cmd.ms);
+            break;
+        case LETK_TIMER_CMD_STOP:
+            letk_timer_stop(cmd.ptimer);
+            break;
+        default:
+            break;
         }
-        pt = pt->next;
     }
 }
 
 /**
- * @brief 移除全部的定时器
+ * @brief 异步启动定时器，可以在中断或其他线程中调用
+ * @param[in] ptimer 定时器指针
+ * @return 是否成功放入命令队列，队列满时返回false
  */
-void letk_timer_remove_all(void)
+bool letk_timer_start_async(letk_timer_t* ptimer)
 {
-    letk_timer_t *ptemp = p_timer_head;
-    letk_timer_t *pnext = ptemp;
+    return letk_timer_cmd_push(ptimer, LETK_TIMER_CMD_START);
+}
 
-    while (ptemp != NULL)
-    {
-        /* 备份下一个 */
-        pnext = ptemp->next;
-        /* 释放指针，防止别人摆弄 */
-        ptemp->next = NULL;
-        /* 移到下一个 */
-        ptemp = pnext;
-    }
+/**
+ * @brief 异步重新启动定时器，可以在中断或其他线程中调用
+ * @param[in] ptimer 定时器指针
+ * @return 是否成功放入命令队列，队列满时返回false
+ */
+bool letk_timer_restart_async(letk_timer_t* ptimer)
+{
+    return letk_timer_cmd_push(ptimer, LETK_TIMER_CMD_RESTART);
+}
 
-    /* 头节点为空 */
-    p_timer_head = NULL;
+/**
+ * @brief 异步停止定时器，可以在中断或其他线程中调用
+ * @param[in] ptimer 定时器指针
+ * @return 是否成功放入命令队列，队列满时返回false
+ */
+bool letk_timer_stop_async(letk_timer_t* ptimer)
+{
+    return letk_timer_cmd_push(ptimer, LETK_TIMER_CMD_STOP);
+}
+#endif  /* LETK_TIMER_CMD_QUEUE_SIZE > 0 */
 
-    list_changed = true;
+#if LETK_TIMER_OFFLOAD_ENABLE
+/**
+ * @brief 设置卸载执行钩子
+ * @param[in] cb 卸载执行钩子，NULL表示全部在轮询中直接运行
+ */
+void letk_timer_set_offload_cb(letk_timer_offload_cb_t* cb)
+{
+    timer_offload_cb = cb;
 }
 
 /**
- * @brief 启动定时器
+ * @brief 设置定时器是否卸载执行
  * @param[in] ptimer 定时器指针
+ * @param[in] offload 是否卸载执行
  */
-void letk_timer_start(letk_timer_t* ptimer)
+void letk_timer_set_offload(letk_timer_t* ptimer, bool offload)
 {
     if (ptimer != NULL)
     {
-        /* 切换为运行态 */
-        ptimer->status = 1;
-        /* 保存当前ticks */
-        ptimer->last = letk_ticks_get_ms();
+        ptimer->offload = offload ? 1 : 0;
     }
 }
+#endif  /* LETK_TIMER_OFFLOAD_ENABLE */
 
+#if LETK_TIMER_STATS_ENABLE
 /**
- * @brief 停止定时器
+ * @brief 设置统计用的高精度时间戳钩子
+ * @param[in] cb 时间戳钩子，NULL表示使用letk_ticks_get_us64
+ */
+void letk_timer_set_clock_cb(letk_timer_clock_cb_t* cb)
+{
+    timer_clock_cb = cb;
+}
+
+/**
+ * @brief 设置定时器名称
  * @param[in] ptimer 定时器指针
+ * @param[in] name 名称，需要保证长期有效
  */
-void letk_timer_stop(letk_timer_t* ptimer)
+void letk_timer_set_name(letk_timer_t* ptimer, const char* name)
 {
     if (ptimer != NULL)
     {
-        /* 切换为挂起态 */
-        ptimer->status = 0;
+        ptimer->name = name;
     }
 }
 
 /**
- * @brief 定时器事件轮询处理
+ * @brief 获取定时器统计信息
+ * @param[in] ptimer 定时器指针(必须非NULL)
+ * @return 统计信息指针
  */
-void letk_timer_poll(void)
+const letk_timer_stats_t* letk_timer_get_stats(const letk_timer_t* ptimer)
 {
-    letk_timer_t* pt;
-    do
+    return &ptimer->stats;
+}
+
+/**
+ * @brief 清除定时器统计信息
+ * @param[in] ptimer 定时器指针(必须非NULL)
+ */
+void letk_timer_reset_stats(letk_timer_t* ptimer)
+{
+    memset(&ptimer->stats, 0, sizeof(ptimer->stats));
+    ptimer->stats.run_min = 0xFFFFFFFFu;
+}
+
+#if LETK_TIMER_STATS_CLI_ENABLE
+/* 判断a是否排在b之前，累计执行时间大的在前，相同时按地址排序 */
+static bool letk_timer_cli_before(const letk_timer_t* a, const letk_timer_t* b)
+{
+    if (a->stats.run_total != b->stats.run_total)
+    {
+        return (a->stats.run_total > b->stats.run_total);
+    }
+    return ((uintptr_t)a < (uintptr_t)b);
+}
+
+/* 打印一个字段，name：字段名，val：字段值 */
+static void letk_timer_cli_put_field(const char* name, uint32_t val)
+{
+    letk_cli_put_str(name);
+    letk_cli_put_uint(val);
+}
+
+/* 命令-timers，按回调累计执行时间从大到小列出统计信息 */
+void letk_timer_cli_cmd(int argc, char* argv[])
+{
+    const letk_timer_t* prev = NULL;
+    const letk_timer_t* best;
+    const letk_timer_t* pt;
+    const letk_timer_stats_t* ps;
+
+    (void)argc;
+    (void)argv;
+
+    /* 不额外占用内存，每次选出排在上一个之后的第一个 */
+    for (;;)
     {
-        list_changed = false;
-        pt = p_timer_head;
-        while (pt != NULL)
+        best = NULL;
+        for (pt = p_timer_head; pt != NULL; pt = pt->next)
         {
-            /* 备份下一个节点 */
-            if (pt->status && pt->repeat &&
-                letk_ticks_is_timeout(pt->last, pt->interval))
+            if (((prev == NULL) || letk_timer_cli_before(prev, pt)) &&
+                ((best == NULL) || letk_timer_cli_before(pt, best)))
             {
-                /* 进行倒计数 */
-                if (pt->repeat > 0)
-                {
-                    --pt->repeat;
-                }
-                /* 重置起始时间 */
-                pt->last = pt->last + pt->interval;
-                /* 运行回调 */
-                if (pt->cb != NULL)
-                {
-                    /* 如果内部调用了add和remove等函数会导致循环异常 */
-                    pt->cb(pt);
-                    /* 链表已发生变化，遍历路径已经被破坏了 */
-                    if (list_changed)
-                    {
-                        break;
-                    }
-                }
+                best = pt;
+            }
+        }
+        if (best == NULL)
+        {
+            break;
+        }
+        ps = &best->stats;
+        letk_cli_put_str("    ");
+        letk_cli_put_str((best->name != NULL) ? best->name : "?");
+        letk_timer_cli_put_field(": cnt=", ps->count);
+        letk_timer_cli_put_field(" late(avg/max)=", (ps->count != 0) ? (ps->late_total / ps->count) : 0);
+        letk_timer_cli_put_field("/", ps->late_max);
+        letk_timer_cli_put_field(" run(min/avg/max)=", (ps->count != 0) ? ps->run_min : 0);
+        letk_timer_cli_put_field("/", (ps->count != 0) ? (uint32_t)(ps->run_total / ps->count) : 0);
+        letk_timer_cli_put_field("/", ps->run_max);
+        letk_cli_put_str("\r\n");
+        prev = best;
+    }
+}
+/* 导出timers命令 */
+LETK_CLI_CMD_EXPORT(timers,
+                  "timers -- list timer callback statistics sorted by cost",
+                  letk_timer_cli_cmd);
+#endif  /* LETK_TIMER_STATS_CLI_ENABLE */
+#endif  /* LETK_TIMER_STATS_ENABLE */
+
+/**
+ * @brief 获取距离最早到期的定时器还有多少ms，用于无滴答休眠
+ * @return 剩余ms数，0表示已有定时器到期，LETK_TIMER_NEXT_NONE表示没有运行中的定时器
+ */
+uint32_t letk_timer_next_expiry_ms(void)
+{
+    uint32_t now = letk_ticks_get_ms();
+    uint32_t remain = LETK_TIMER_NEXT_NONE;
+    uint32_t left;
+
+#if LETK_TIMER_CMD_QUEUE_SIZE > 0
+    if (!letk_timer_cmd_empty())
+    {
+        /* 还有未执行的命令，需要立即轮询 */
+        return 0;
+    }
+#endif  /* LETK_TIMER_CMD_QUEUE_SIZE > 0 */
+
+#if LETK_TIMER_ENGINE != LETK_TIMER_ENGINE_LIST
+    uint32_t expire;
+
+    if (letk_timer_sched_next(&expire))
+    {
+        left = expire - now;
+        remain = ((int32_t)left > 0) ? left : 0;
+    }
+#else   /* LETK_TIMER_ENGINE != LETK_TIMER_ENGINE_LIST */
+    const letk_timer_t* pt;
+    uint32_t elapsed, expire;
+
+    for (pt = p_timer_head; (pt != NULL) && (remain != 0); pt = pt->next)
+    {
+        if (pt->status && pt->repeat)
+        {
+            elapsed = now - pt->last;
+            expire = pt->interval + LETK_TIMER_GET_SLACK(pt);
+            left = (elapsed >= expire) ? 0 : (expire - elapsed);
+            if (left < remain)
+            {
+                remain = left;
             }
-            /* 下一个 */
-            pt = pt->next;
         }
-    } while (pt != NULL);
+    }
+#endif  /* LETK_TIMER_ENGINE != LETK_TIMER_ENGINE_LIST */
+
+    return remain;
+}
+
+/**
+ * @brief 判断轮询预算是否已用完
+ * @param[in] count 已运行的回调次数
+ * @param[in] max_callbacks 最多运行的回调次数，0表示不限
+ * @param[in] start 轮询开始时刻，单位us
+ * @param[in] max_us 最长运行时间，单位us，0表示不限
+ * @return 是否已用完
+ */
+static bool letk_timer_budget_spent(uint32_t count, uint32_t max_callbacks, uint64_t start, uint32_t max_us)
+{
+    if ((max_callbacks > 0) && (count >= max_callbacks))
+    {
+        return true;
+    }
+    return (max_us > 0) && ((letk_ticks_get_us64() - start) >= max_us);
+}
+
+/**
+ * @brief 按预算运行到期定时器的回调，高优先级的先运行
+ * @param[in] max_callbacks 最多运行的回调次数，0表示不限
+ * @param[in] max_us 最长运行时间，单位us，0表示不限
+ * @return 运行的回调次数
+ */
+static uint32_t letk_timer_dispatch(uint32_t max_callbacks, uint32_t max_us)
+{
+    letk_timer_t* pt;
+    uint32_t count = 0;
+    uint64_t start = (max_us > 0) ? letk_ticks_get_us64() : 0;
+
+#if LETK_TIMER_CMD_QUEUE_SIZE > 0
+    /* 先执行中断和其他线程发来的命令 */
+    letk_timer_cmd_drain();
+#endif  /* LETK_TIMER_CMD_QUEUE_SIZE > 0 */
+
+#if LETK_TIMER_ENGINE != LETK_TIMER_ENGINE_LIST
+    if (!letk_timer_sched_collect(letk_ticks_get_ms()))
+    {
+        return 0;
+    }
+
+    /* 回调中可以任意调用add/remove/start/stop */
+    while ((pt = letk_timer_sched_pop_run()) != NULL)
+    {
+        letk_timer_fire(pt);
+        /* 回调中未重新启动的，按新的起始时间重新调度 */
+        if (!letk_timer_sched_contains(pt))
+        {
+            letk_timer_reschedule(pt);
+        }
+        if (letk_timer_budget_spent(++count, max_callbacks, start, max_us))
+        {
+            /* 预算用完，剩余的到期定时器留到下一次轮询 */
+            letk_timer_sched_defer_run();
+            break;
+        }
+    }
+#else   /* LETK_TIMER_ENGINE != LETK_TIMER_ENGINE_LIST */
+    /* 只遍历一遍链表收集到期的定时器，回调中添加的定时器下一次轮询才会处理 */
+    if (!letk_timer_list_collect())
+    {
+        return 0;
+    }
+
+    /* 回调中移除的定时器从处理链表断开，停止或重新启动的不再到期，均不会运行 */
+    while ((pt = letk_timer_list_pop_run()) != NULL)
+    {
+        if (!(pt->status && pt->repeat && letk_ticks_is_timeout(pt->last, pt->interval)))
+        {
+            continue;
+        }
+        letk_timer_fire(pt);
+        if (letk_timer_budget_spent(++count, max_callbacks, start, max_us))
+        {
+            /* 预算用完，未运行的到期定时器仍处于到期状态，下一次轮询处理 */
+            letk_timer_list_run_clear();
+            break;
+        }
+    }
+#endif  /* LETK_TIMER_ENGINE != LETK_TIMER_ENGINE_LIST */
+
+    return count;
+}
+
+/**
+ * @brief 定时器事件轮询处理
+ */
+void letk_timer_poll(void)
+{
+    (void)letk_timer_dispatch(0, 0);
+}
+
+#if LETK_TIMER_PRIORITY_LEVELS > 0
+/**
+ * @brief 限定预算的定时器事件轮询处理
+ * @param[in] max_callbacks 最多运行的回调次数，0表示不限
+ * @param[in] max_us 最长运行时间，单位us，0表示不限
+ * @return 运行的回调次数
+ */
+uint32_t letk_timer_poll_budget(uint32_t max_callbacks, uint32_t max_us)
+{
+    return letk_timer_dispatch(max_callbacks, max_us);
 }
+#endif  /* LETK_TIMER_PRIORITY_LEVELS > 0 */
 
 #ifdef __cplusplus
 }
@@ -13,11 +13,29 @@
 ** 修改日期         修改作者        修改内容
 ** 2022年5月29日    付瑞彪          创建文件，初次版本
 ** 2022年7月15日    付瑞彪          修改代码注释规范
+** 2026年10月18日   付瑞彪          增加分级时间轮调度引擎
+** 2026年10月18日   付瑞彪          增加最小堆调度引擎
+** 2026年10月18日   付瑞彪          改为双向链表，添加和移除为O(1)
+** 2026年10月18日   付瑞彪          回调中修改链表不再导致轮询从头重新遍历
+** 2026年10月18日   付瑞彪          增加下一次到期时间查询，支持无滴答休眠
+** 2026年10月18日   付瑞彪          增加松弛时间，合并触发相近的定时器
+** 2026年10月18日   付瑞彪          增加中断和多线程安全的无锁命令队列
+** 2026年10月18日   付瑞彪          增加回调延迟和执行时间统计
+** 2026年10月18日   付瑞彪          增加周期定时器的超期处理策略
+** 2026年10月18日   付瑞彪          增加基于固定定时器池的一次性和周期调用接口
+** 2026年10月18日   付瑞彪          增加卸载执行，耗时回调可以交给工作线程运行
+** 2026年10月18日   付瑞彪          统计的时间戳默认使用64位us时间戳
+** 2026年10月18日   付瑞彪          增加定时器优先级和限定预算的轮询接口
+** 2026年10月18日   付瑞彪          最小堆改为嵌入定时器的配对堆，不再有容量上限
+** 2026年10月18日   付瑞彪          最小堆引擎的处理链表改为双向链表，回调中移除的定时器立即断链
+** 2026年10月18日   付瑞彪          链表引擎增加按优先级的处理链表，轮询只遍历一遍链表
+** 2026年10月18日   付瑞彪          命令队列长度不能为1
 **
 ***********************************************************************************************************************/
 #ifndef __LETK_TIMER_H__
 #define __LETK_TIMER_H__
 
+#include "letk_timer_cfg.h"
 #include <stdint.h>
 #ifndef __cplusplus
 #include <stdbool.h>
@@ -27,22 +45,173 @@
 extern 'C' {
 #endif  /* __cplusplus */
 
+/* 定时器调度引擎 */
+#define LETK_TIMER_ENGINE_LIST      0   /* 链表轮询 */
+#define LETK_TIMER_ENGINE_WHEEL     1   /* 分级时间轮 */
+#define LETK_TIMER_ENGINE_HEAP      2   /* 到期时刻最小堆 */
+
+/* 默认采用链表轮询 */
+#ifndef LETK_TIMER_ENGINE
+#define LETK_TIMER_ENGINE           LETK_TIMER_ENGINE_LIST
+#endif  /* LETK_TIMER_ENGINE */
+
+#if LETK_TIMER_ENGINE == LETK_TIMER_ENGINE_WHEEL
+#ifndef LETK_TIMER_WHEEL_BITS
+#define LETK_TIMER_WHEEL_BITS       4
+#endif  /* LETK_TIMER_WHEEL_BITS */
+#if (LETK_TIMER_WHEEL_BITS < 1) || (LETK_TIMER_WHEEL_BITS > 8)
+#error LETK_TIMER_WHEEL_BITS must be in range [1-8]
+#endif
+#endif  /* LETK_TIMER_ENGINE == LETK_TIMER_ENGINE_WHEEL */
+
+/* 默认不使能松弛时间 */
+#ifndef LETK_TIMER_SLACK_ENABLE
+#define LETK_TIMER_SLACK_ENABLE     0
+#endif  /* LETK_TIMER_SLACK_ENABLE */
+
+/* 超期处理策略 */
+#define LETK_TIMER_OVERRUN_CATCH_UP 0   /* 连续补触发错过的周期 */
+#define LETK_TIMER_OVERRUN_SKIP     1   /* 只触发一次，跳过错过的周期，对齐到下一个周期点 */
+#define LETK_TIMER_OVERRUN_REPORT   2   /* 同SKIP，并在回调中报告错过的周期数 */
+
+/* 默认不使能超期处理策略，错过的周期全部补触发 */
+#ifndef LETK_TIMER_OVERRUN_ENABLE
+#define LETK_TIMER_OVERRUN_ENABLE   0
+#endif  /* LETK_TIMER_OVERRUN_ENABLE */
+
+/* 默认不使能优先级 */
+#ifndef LETK_TIMER_PRIORITY_LEVELS
+#define LETK_TIMER_PRIORITY_LEVELS  0
+#endif  /* LETK_TIMER_PRIORITY_LEVELS */
+
+#if LETK_TIMER_PRIORITY_LEVELS > 256
+#error LETK_TIMER_PRIORITY_LEVELS must be in range [0-256]
+#endif
+
+/* 默认不使能卸载执行 */
+#ifndef LETK_TIMER_OFFLOAD_ENABLE
+#define LETK_TIMER_OFFLOAD_ENABLE   0
+#endif  /* LETK_TIMER_OFFLOAD_ENABLE */
+
+/* 默认不使能动态定时器池 */
+#ifndef LETK_TIMER_POOL_SIZE
+#define LETK_TIMER_POOL_SIZE        0
+#endif  /* LETK_TIMER_POOL_SIZE */
+
+#if LETK_TIMER_POOL_SIZE > 0xFFFF
+#error LETK_TIMER_POOL_SIZE must be in range [0-65535]
+#endif
+
+/* 默认不使能命令队列 */
+#ifndef LETK_TIMER_CMD_QUEUE_SIZE
+#define LETK_TIMER_CMD_QUEUE_SIZE   0
+#endif  /* LETK_TIMER_CMD_QUEUE_SIZE */
+
+#ifndef LETK_TIMER_CMD_QUEUE_MPSC
+#define LETK_TIMER_CMD_QUEUE_MPSC   0
+#endif  /* LETK_TIMER_CMD_QUEUE_MPSC */
+
+/* 长度为1时多生产者的序号无法区分空和满，槽会被覆盖 */
+#if ((LETK_TIMER_CMD_QUEUE_SIZE & (LETK_TIMER_CMD_QUEUE_SIZE - 1)) != 0) || (LETK_TIMER_CMD_QUEUE_SIZE == 1)
+#error LETK_TIMER_CMD_QUEUE_SIZE must be 0 or a power of 2 not less than 2
+#endif
+
+/* 默认不使能统计 */
+#ifndef LETK_TIMER_STATS_ENABLE
+#define LETK_TIMER_STATS_ENABLE     0
+#endif  /* LETK_TIMER_STATS_ENABLE */
+
+#ifndef LETK_TIMER_STATS_CLI_ENABLE
+#define LETK_TIMER_STATS_CLI_ENABLE 0
+#endif  /* LETK_TIMER_STATS_CLI_ENABLE */
+
+/* 没有运行中的定时器时，下一次到期时间的返回值 */
+#define LETK_TIMER_NEXT_NONE        0xFFFFFFFFu
+
 /* 定时器类型定义 */
 typedef struct _letk_timer_t letk_timer_t;
 
 /* 定时器回调函数原型定义 */
 typedef void letk_timer_cb_t(letk_timer_t*);
 
+#if LETK_TIMER_STATS_ENABLE
+/* 高精度时间戳钩子原型定义，返回自由运行的计数值，允许溢出回绕 */
+typedef uint32_t letk_timer_clock_cb_t(void);
+
+/* 定时器统计，回调执行时间的单位由时间戳钩子决定，默认为us */
+typedef struct
+{
+    uint32_t count;             /* 触发次数 */
+    uint32_t late_max;          /* 最大触发延迟，单位ms */
+    uint32_t late_total;        /* 累计触发延迟，单位ms */
+    uint32_t run_min;           /* 最短回调执行时间 */
+    uint32_t run_max;           /* 最长回调执行时间 */
+    uint64_t run_total;         /* 累计回调执行时间 */
+} letk_timer_stats_t;
+#endif  /* LETK_TIMER_STATS_ENABLE */
+
+#if LETK_TIMER_POOL_SIZE > 0
+/* 动态定时器ID类型定义 */
+typedef uint32_t letk_timer_id_t;
+
+/* 无效的动态定时器ID */
+#define LETK_TIMER_ID_NONE          0u
+
+/* 动态定时器回调函数原型定义 */
+typedef void letk_timer_call_cb_t(void* arg);
+#endif  /* LETK_TIMER_POOL_SIZE > 0 */
+
+#if LETK_TIMER_OFFLOAD_ENABLE
+/* 卸载执行钩子原型定义，负责在其他执行环境中调用ptimer->cb(ptimer) */
+typedef void letk_timer_offload_cb_t(letk_timer_t* ptimer);
+#endif  /* LETK_TIMER_OFFLOAD_ENABLE */
+
 /* 定时器结构 */
 struct _letk_timer_t
 {
     letk_timer_t* next;         /* 下一个节点指针，不要随意摆弄*/
+    letk_timer_t* prev;         /* 上一个节点指针，不要随意摆弄*/
     letk_timer_cb_t* cb;        /* 回调函数 */
     void* user_data;            /* 用户数据指针 */
     int32_t repeat;             /* >0：重复次数，0：运行结束，<0：无限循环 */
     uint32_t interval;          /* 间隔周期 */
     uint32_t last;              /* 上一次运行时间 */
     uint8_t status;             /* 定时器状态，0：停止，1：启动 */
+    uint8_t linked;             /* 是否已添加到链表，不要随意摆弄 */
+#if LETK_TIMER_SLACK_ENABLE
+    uint32_t slack;             /* 松弛时间，到期后最多可延后的ms数 */
+#endif  /* LETK_TIMER_SLACK_ENABLE */
+#if LETK_TIMER_OVERRUN_ENABLE
+    uint32_t missed;            /* 本次触发前错过的周期数，仅LETK_TIMER_OVERRUN_REPORT策略有效 */
+    uint8_t overrun;            /* 超期处理策略 */
+#endif  /* LETK_TIMER_OVERRUN_ENABLE */
+#if LETK_TIMER_PRIORITY_LEVELS > 0
+    uint8_t priority;           /* 优先级，数值越大越优先 */
+#endif  /* LETK_TIMER_PRIORITY_LEVELS > 0 */
+#if LETK_TIMER_OFFLOAD_ENABLE
+    uint8_t offload;            /* 是否卸载执行，0：在轮询中直接运行，1：交给卸载执行钩子 */
+#endif  /* LETK_TIMER_OFFLOAD_ENABLE */
+#if LETK_TIMER_STATS_ENABLE
+    letk_timer_stats_t stats;   /* 统计信息 */
+    const char* name;           /* 名称，用于统计信息显示 */
+#endif  /* LETK_TIMER_STATS_ENABLE */
+#if LETK_TIMER_ENGINE != LETK_TIMER_ENGINE_LIST
+    uint32_t expire;            /* 到期时刻 */
+#endif  /* LETK_TIMER_ENGINE != LETK_TIMER_ENGINE_LIST */
+#if LETK_TIMER_ENGINE == LETK_TIMER_ENGINE_LIST
+    letk_timer_t* run_next;     /* 到期处理链表下一个节点指针，不要随意摆弄 */
+    letk_timer_t** run_pprev;   /* 指向前一节点next的指针，NULL表示不在处理链表中，不要随意摆弄 */
+#elif LETK_TIMER_ENGINE == LETK_TIMER_ENGINE_WHEEL
+    letk_timer_t* wheel_next;   /* 时间轮槽链表下一个节点指针，不要随意摆弄 */
+    letk_timer_t** wheel_pprev; /* 指向前一节点next的指针，NULL表示不在时间轮中，不要随意摆弄 */
+#elif LETK_TIMER_ENGINE == LETK_TIMER_ENGINE_HEAP
+    letk_timer_t* heap_next;    /* 到期处理链表下一个节点指针，不要随意摆弄 */
+    letk_timer_t** heap_pprev;  /* 到期处理链表中指向前一节点next的指针，不要随意摆弄 */
+    letk_timer_t* heap_child;   /* 堆中第一个子节点指针，不要随意摆弄 */
+    letk_timer_t* heap_sibling; /* 堆中下一个兄弟节点指针，不要随意摆弄 */
+    letk_timer_t* heap_prev;    /* 第一个子节点指向父节点，其余指向前一个兄弟，不要随意摆弄 */
+    uint8_t heap_state;         /* 在堆中的状态，不要随意摆弄 */
+#endif  /* LETK_TIMER_ENGINE */
 };
 
 /**
@@ -62,6 +231,7 @@ void letk_timer_init(letk_timer_t* ptimer,
 /**
  * @brief 添加定时器到链表
  * @param[in] ptimer 待添加的定时器指针
+ * @note 已在链表中的定时器不会重复添加，定时器必须先调用letk_timer_init初始化
  */
 void letk_timer_add(letk_timer_t* ptimer);
 
@@ -76,9 +246,49 @@ void letk_timer_remove(letk_timer_t* ptimer);
  */
 void letk_timer_remove_all(void);
 
+#if LETK_TIMER_SLACK_ENABLE
+/**
+ * @brief 设置定时器的松弛时间
+ * @param[in] ptimer 定时器指针
+ * @param[in] slack 松弛时间，到期后最多可延后的ms数，0表示准时触发
+ * @note 到期的定时器会等到有定时器必须触发时一起触发，从而减少唤醒次数，
+ *       下一次启动或到期后生效
+ */
+void letk_timer_set_slack(letk_timer_t* ptimer, uint32_t slack);
+#endif  /* LETK_TIMER_SLACK_ENABLE */
+
+#if LETK_TIMER_OVERRUN_ENABLE
+/**
+ * @brief 设置定时器的超期处理策略
+ * @param[in] ptimer 定时器指针
+ * @param[in] policy 超期处理策略，LETK_TIMER_OVERRUN_XXX，默认LETK_TIMER_OVERRUN_CATCH_UP
+ * @note 延迟达到一个周期以上视为超期，SKIP和REPORT策略下错过的周期不消耗重复次数
+ */
+void letk_timer_set_overrun(letk_timer_t* ptimer, uint8_t policy);
+
+/**
+ * @brief 获取本次触发前错过的周期数，在回调中调用
+ * @param[in] ptimer 定时器指针(必须非NULL)
+ * @return 错过的周期数，0表示准时，仅LETK_TIMER_OVERRUN_REPORT策略有效
+ */
+uint32_t letk_timer_get_missed(const letk_timer_t* ptimer);
+#endif  /* LETK_TIMER_OVERRUN_ENABLE */
+
+#if LETK_TIMER_PRIORITY_LEVELS > 0
+/**
+ * @brief 设置定时器的优先级
+ * @param[in] ptimer 定时器指针
+ * @param[in] priority 优先级，范围[0, LETK_TIMER_PRIORITY_LEVELS-1]，数值越大越优先，超出范围按最高优先级处理，默认0
+ * @note 同一次轮询中到期的定时器按优先级从高到低运行，同优先级之间的顺序不确定，下一次到期后生效
+ */
+void letk_timer_set_priority(letk_timer_t* ptimer, uint8_t priority);
+#endif  /* LETK_TIMER_PRIORITY_LEVELS > 0 */
+
 /**
  * @brief 启动定时器
  * @param[in] ptimer 定时器指针
+ * @note 时间轮和最小堆引擎在启动时按当前参数计算到期时刻，运行中修改interval和repeat
+ *       需要重新调用此函数才能生效
  */
 void letk_timer_start(letk_timer_t* ptimer);
 
@@ -88,11 +298,138 @@ void letk_timer_start(letk_timer_t* ptimer);
  */
 void letk_timer_stop(letk_timer_t* ptimer);
 
+#if LETK_TIMER_POOL_SIZE > 0
+/**
+ * @brief 延时调用，从定时器池分配一个单次定时器，触发后自动释放
+ * @param[in] ms 延时ms数
+ * @param[in] cb 回调函数
+ * @param[in] arg 回调参数
+ * @return 定时器ID，用于取消，定时器池已满或cb为NULL时返回LETK_TIMER_ID_NONE
+ */
+letk_timer_id_t letk_timer_call_after(uint32_t ms, letk_timer_call_cb_t* cb, void* arg);
+
+/**
+ * @brief 周期调用，从定时器池分配一个无限循环的定时器，取消后释放
+ * @param[in] ms 周期ms数
+ * @param[in] cb 回调函数
+ * @param[in] arg 回调参数
+ * @return 定时器ID，用于取消，定时器池已满或cb为NULL时返回LETK_TIMER_ID_NONE
+ */
+letk_timer_id_t letk_timer_call_every(uint32_t ms, letk_timer_call_cb_t* cb, void* arg);
+
+/**
+ * @brief 取消延时调用或周期调用，并释放定时器，可以在回调中调用
+ * @param[in] id 定时器ID
+ * @return 是否成功，定时器已触发释放或ID无效时返回false
+ */
+bool letk_timer_cancel(letk_timer_id_t id);
+#endif  /* LETK_TIMER_POOL_SIZE > 0 */
+
+#if LETK_TIMER_CMD_QUEUE_SIZE > 0
+/**
+ * @brief 异步启动定时器，可以在中断或其他线程中调用
+ * @param[in] ptimer 定时器指针
+ * @return 是否成功放入命令队列，队列满时返回false
+ * @note 命令在下一次letk_timer_poll开始时执行，起始时间为调用此函数的时刻，已在运行的定时器不受影响
+ */
+bool letk_timer_start_async(letk_timer_t* ptimer);
+
+/**
+ * @brief 异步重新启动定时器，可以在中断或其他线程中调用
+ * @param[in] ptimer 定时器指针
+ * @return 是否成功放入命令队列，队列满时返回false
+ * @note 命令在下一次letk_timer_poll开始时执行，起始时间为调用此函数的时刻
+ */
+bool letk_timer_restart_async(letk_timer_t* ptimer);
+
+/**
+ * @brief 异步停止定时器，可以在中断或其他线程中调用
+ * @param[in] ptimer 定时器指针
+ * @return 是否成功放入命令队列，队列满时返回false
+ * @note 命令在下一次letk_timer_poll开始时执行
+ */
+bool letk_timer_stop_async(letk_timer_t* ptimer);
+#endif  /* LETK_TIMER_CMD_QUEUE_SIZE > 0 */
+
+#if LETK_TIMER_OFFLOAD_ENABLE
+/**
+ * @brief 设置卸载执行钩子
+ * @param[in] cb 卸载执行钩子，NULL表示全部在轮询中直接运行
+ * @note 钩子在轮询中调用，应只做投递，不要阻塞
+ */
+void letk_timer_set_offload_cb(letk_timer_offload_cb_t* cb);
+
+/**
+ * @brief 设置定时器是否卸载执行
+ * @param[in] ptimer 定时器指针
+ * @param[in] offload 是否卸载执行，用于可能阻塞的耗时回调
+ * @note 卸载执行时统计的回调执行时间只包含投递时间
+ */
+void letk_timer_set_offload(letk_timer_t* ptimer, bool offload);
+#endif  /* LETK_TIMER_OFFLOAD_ENABLE */
+
+#if LETK_TIMER_STATS_ENABLE
+/**
+ * @brief 设置统计用的高精度时间戳钩子
+ * @param[in] cb 时间戳钩子，例如读取DWT周期计数器或硬件定时器，NULL表示使用letk_ticks_get_us64，单位us
+ * @note 每次触发只读取两次时间戳，钩子应尽量轻量
+ */
+void letk_timer_set_clock_cb(letk_timer_clock_cb_t* cb);
+
+/**
+ * @brief 设置定时器名称
+ * @param[in] ptimer 定时器指针
+ * @param[in] name 名称，用于统计信息显示，需要保证长期有效
+ * @note letk_timer_init会清除名称，需要在其后调用
+ */
+void letk_timer_set_name(letk_timer_t* ptimer, const char* name);
+
+/**
+ * @brief 获取定时器统计信息
+ * @param[in] ptimer 定时器指针(必须非NULL)
+ * @return 统计信息指针
+ */
+const letk_timer_stats_t* letk_timer_get_stats(const letk_timer_t* ptimer);
+
+/**
+ * @brief 清除定时器统计信息
+ * @param[in] ptimer 定时器指针(必须非NULL)
+ */
+void letk_timer_reset_stats(letk_timer_t* ptimer);
+
+#if LETK_TIMER_STATS_CLI_ENABLE
+/* 命令-timers，按回调累计执行时间从大到小列出统计信息，静态注册命令时需要用户手动放入命令表 */
+void letk_timer_cli_cmd(int argc, char* argv[]);
+#endif  /* LETK_TIMER_STATS_CLI_ENABLE */
+#endif  /* LETK_TIMER_STATS_ENABLE */
+
+/**
+ * @brief 获取距离最早到期的定时器还有多少ms，用于无滴答休眠
+ * @return 剩余ms数，0表示已有定时器到期，LETK_TIMER_NEXT_NONE表示没有运行中的定时器
+ * @note 使能松弛时间时按到期时刻加松弛时间计算，即最晚必须唤醒的时刻，
+ *       链表引擎需要遍历全部定时器，时间轮引擎需要扫描各级槽，最小堆引擎直接读取堆顶
+ */
+uint32_t letk_timer_next_expiry_ms(void);
+
 /**
  * @brief 定时器事件轮询处理
+ * @note 回调中可以调用add/remove/start/stop，回调中添加的定时器下一次轮询才处理，
+ *       一次轮询中每个定时器最多运行一次回调
  */
 void letk_timer_poll(void);
 
+#if LETK_TIMER_PRIORITY_LEVELS > 0
+/**
+ * @brief 限定预算的定时器事件轮询处理，按优先级从高到低运行到期定时器的回调，预算用完即返回
+ * @param[in] max_callbacks 最多运行的回调次数，0表示不限
+ * @param[in] max_us 最长运行时间，单位us，0表示不限，每次回调结束后检查，可能超出一个回调的执行时间
+ * @return 运行的回调次数
+ * @note 未来得及运行的到期定时器留到下一次轮询，此时letk_timer_next_expiry_ms返回0，
+ *       运行时间由letk_ticks_get_us64计量，未设置硬件计数器时精度为1ms
+ */
+uint32_t letk_timer_poll_budget(uint32_t max_callbacks, uint32_t max_us);
+#endif  /* LETK_TIMER_PRIORITY_LEVELS > 0 */
+
 #ifdef __cplusplus
 }
 #endif  /* __cplusplus */
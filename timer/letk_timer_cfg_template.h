@@ -0,0 +1,69 @@
+/***********************************************************************************************************************
+** 文件描述：定时器管理(软件定时器)配置文件
+** 创建作者：付瑞彪(Tom Free)
+** 创建日期：2026年10月18日
+** 编码格式：UTF-8编码
+** 编程语言：C语言，C99标准
+** 缩进格式：4个空格键
+** 命名规范：下划线命名法(小写命名法)
+** 开源许可：MIT许可证，参考：https://mit-license.org
+** 版权信息：Copyright (c) 2013-2022, Tom Free, <tomfreefu@gmail.com>
+**
+** 修改记录
+** 修改日期         修改作者        修改内容
+** 2026年10月18日   付瑞彪          创建文件，初次版本
+**
+***********************************************************************************************************************/
+#ifndef __LETK_TIMER_CFG_H__
+#define __LETK_TIMER_CFG_H__
+
+/* 定时器调度引擎，可选：
+ * LETK_TIMER_ENGINE_LIST：链表轮询，每次轮询遍历全部定时器，RAM占用最少，适合定时器数量少的场合
+ * LETK_TIMER_ENGINE_WHEEL：分级时间轮，启动、停止和到期处理都是O(1)，适合定时器数量多的场合
+ * LETK_TIMER_ENGINE_HEAP：到期时刻最小堆(配对堆)，启动O(1)，停止均摊O(logN)，没有到期定时器时轮询只需一次比较，
+ *                        不限定时器数量 */
+#define LETK_TIMER_ENGINE               LETK_TIMER_ENGINE_LIST
+
+/* 时间轮每级槽位数的位数，即每级2^N个槽位，范围[1-8]，级数自动计算以覆盖32位时间 */
+#define LETK_TIMER_WHEEL_BITS           4
+
+/* 是否使能定时器松弛时间，允许定时器延后触发，与其他定时器合并到同一次唤醒中 */
+#define LETK_TIMER_SLACK_ENABLE         0
+
+/* 是否使能超期处理策略，可为每个定时器设置长时间阻塞后错过的周期是补触发、跳过还是跳过并报告 */
+#define LETK_TIMER_OVERRUN_ENABLE       0
+
+/* 定时器优先级数量，范围[1-256]，优先级为[0, N-1]，数值越大越优先，同一次轮询中到期的定时器
+ * 按优先级从高到低运行，并提供限定回调次数和运行时间的轮询接口letk_timer_poll_budget，0表示不使能 */
+#define LETK_TIMER_PRIORITY_LEVELS      0
+
+/* 是否使能卸载执行，标记为卸载的定时器到期后交给用户设置的执行钩子(例如工作线程)运行，不阻塞轮询 */
+#define LETK_TIMER_OFFLOAD_ENABLE       0
+
+/* 是否使能Linux主机定时器服务(letk_timer_linux.c)，调度线程按最近到期时刻休眠，
+ * 卸载的回调由工作线程池运行，需要使能卸载执行和POSIX线程 */
+#define LETK_TIMER_LINUX_ENABLE         0
+/* Linux定时器服务的工作线程数 */
+#define LETK_TIMER_LINUX_WORKERS        2
+/* Linux定时器服务的卸载队列长度，队列满时本次回调被合并，不在调度线程中运行 */
+#define LETK_TIMER_LINUX_QUEUE_SIZE     16
+
+/* 是否使能虚拟时间仿真(letk_timer_sim.c)，时间只在需要时前进，用于主机上快速确定地运行长时间测试，
+ * 使能后不能再由中断或其他线程调用letk_ticks_inc_ms */
+#define LETK_TIMER_SIM_ENABLE           0
+
+/* 动态定时器池容量，用于letk_timer_call_after/letk_timer_call_every，0表示不使能 */
+#define LETK_TIMER_POOL_SIZE            0
+
+/* 无锁命令队列长度，必须是不小于2的2的N次幂，用于在中断或其他线程中启动和停止定时器，0表示不使能 */
+#define LETK_TIMER_CMD_QUEUE_SIZE       0
+/* 命令队列是否支持多个生产者(多个中断优先级或多个线程)，需要编译器支持C11的stdatomic.h，
+ * 0表示只有一个生产者(例如只在一个中断中调用)，仅依赖volatile，适合单核MCU */
+#define LETK_TIMER_CMD_QUEUE_MPSC       0
+
+/* 是否使能定时器统计，记录触发延迟、回调执行时间和触发次数，用于找出耗时的回调 */
+#define LETK_TIMER_STATS_ENABLE         0
+/* 是否导出统计信息查看命令(timers)，需要使能统计功能和CLI模块 */
+#define LETK_TIMER_STATS_CLI_ENABLE     0
+
+#endif  /* __LETK_TIMER_CFG_H__ */
@@ -0,0 +1,349 @@
+/***********************************************************************************************************************
+** 文件描述：Linux主机定时器服务源文件，调度线程驱动滴答时钟和定时器轮询，卸载的回调由工作线程池运行
+** 创建作者：付瑞彪(Tom Free)
+** 创建日期：2026年10月18日
+** 编码格式：UTF-8编码
+** 编程语言：C语言，C99标准
+** 缩进格式：4个空格键
+** 命名规范：下划线命名法(小写命名法)
+** 开源许可：MIT许可证，参考：https://mit-license.org
+** 版权信息：Copyright (c) 2013-2022, Tom Free, <tomfreefu@gmail.com>
+**
+** 修改记录
+** 修改日期         修改作者        修改内容
+** 2026年10月18日   付瑞彪          创建文件，初次版本
+** 2026年10月18日   付瑞彪          有已到期的定时器时休眠到下一个ms边界，不再空转；运行标志在锁内读取
+** 2026年10月18日   付瑞彪          卸载队列满时合并本次回调并计数，不再在调度线程中直接运行
+** 2026年10月18日   付瑞彪          定义_POSIX_C_SOURCE，严格C99/C11模式下也能编译
+**
+***********************************************************************************************************************/
+/* 严格C99/C11模式下clock_gettime和pthread_condattr_setclock需要POSIX声明，必须在第一个头文件之前定义 */
+#define _POSIX_C_SOURCE 200809L
+
+#include "letk_timer_linux.h"
+
+#if LETK_TIMER_LINUX_ENABLE
+
+#include "letk_ticks.h"
+#include <stddef.h>
+#include <pthread.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif  /* __cplusplus */
+
+/* 服务锁，保护定时器链表和滴答时钟，调度线程在轮询时持有 */
+static pthread_mutex_t svc_mutex = PTHREAD_MUTEX_INITIALIZER;
+/* 调度线程休眠用的条件变量，使用单调时钟 */
+static pthread_cond_t svc_cond;
+/* 调度线程 */
+static pthread_t svc_thread;
+/* 上一次同步滴答时钟的单调时刻，单位ns */
+static uint64_t svc_sync_ns = 0;
+
+/* 卸载队列锁 */
+static pthread_mutex_t work_mutex = PTHREAD_MUTEX_INITIALIZER;
+/* 工作线程等待用的条件变量 */
+static pthread_cond_t work_cond = PTHREAD_COND_INITIALIZER;
+/* 卸载队列 */
+static letk_timer_t* work_queue[LETK_TIMER_LINUX_QUEUE_SIZE];
+/* 卸载队列读位置和长度 */
+static uint32_t work_front = 0;
+static uint32_t work_count = 0;
+/* 上一次还没运行完或队列已满而合并掉的回调次数 */
+static uint32_t work_skipped = 0;
+/* 每个工作线程正在运行的定时器，用于防止同一个定时器并发运行 */
+static letk_timer_t* work_busy[LETK_TIMER_LINUX_WORKERS];
+/* 工作线程 */
+static pthread_t work_thread[LETK_TIMER_LINUX_WORKERS];
+
+/* 服务是否运行中，受两把锁共同保护 */
+static bool svc_running = false;
+
+/**
+ * @brief 读取单调时钟
+ * @return 单调时刻，单位ns
+ */
+static uint64_t letk_timer_linux_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief 把流逝的整ms数同步到滴答时钟，需要持有服务锁
+ */
+static void letk_timer_linux_sync_ticks(void)
+{
+    uint64_t elapsed = (letk_timer_linux_now_ns() - svc_sync_ns) / 1000000u;
+
+    if (elapsed > 0)
+    {
+        /* 不足1ms的部分留到下一次 */
+        svc_sync_ns += elapsed * 1000000u;
+        letk_ticks_inc_ms((uint32_t)elapsed);
+    }
+}
+
+/**
+ * @brief 判断定时器是否已在卸载队列中或正在运行，需要持有卸载队列锁
+ * @param[in] pt 定时器指针
+ * @return 是否已在处理中
+ */
+static bool letk_timer_linux_pending(const letk_timer_t* pt)
+{
+    uint32_t i;
+
+    for (i = 0; i < work_count; i++)
+    {
+        if (work_queue[(work_front + i) % LETK_TIMER_LINUX_QUEUE_SIZE] == pt)
+        {
+            return true;
+        }
+    }
+    for (i = 0; i < LETK_TIMER_LINUX_WORKERS; i++)
+    {
+        if (work_busy[i] == pt)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 卸载执行钩子，在调度线程的轮询中调用，把定时器投递到卸载队列
+ * @param[in] pt 定时器指针
+ */
+static void letk_timer_linux_offload(letk_timer_t* pt)
+{
+    pthread_mutex_lock(&work_mutex);
+    if (letk_timer_linux_pending(pt) || (work_count >= LETK_TIMER_LINUX_QUEUE_SIZE))
+    {
+        /* 上一次还没运行完或队列已满，本次合并，避免回调堆积；
+         * 调度线程持有服务锁，不能在这里直接运行可能加锁或阻塞的回调 */
+        work_skipped++;
+    }
+    else
+    {
+        work_queue[(work_front + work_count) % LETK_TIMER_LINUX_QUEUE_SIZE] = pt;
+        work_count++;
+        pthread_cond_signal(&work_cond);
+    }
+    pthread_mutex_unlock(&work_mutex);
+}
+
+/**
+ * @brief 工作线程，运行卸载执行的回调
+ * @param[in] arg 工作线程序号
+ * @return 无
+ */
+static void* letk_timer_linux_worker(void* arg)
+{
+    uint32_t id = (uint32_t)(uintptr_t)arg;
+    letk_timer_t* pt;
+
+    pthread_mutex_lock(&work_mutex);
+    for (;;)
+    {
+        while (svc_running && (work_count == 0))
+        {
+            pthread_cond_wait(&work_cond, &work_mutex);
+        }
+        if (!svc_running)
+        {
+            break;
+        }
+        pt = work_queue[work_front];
+        work_front = (work_front + 1) % LETK_TIMER_LINUX_QUEUE_SIZE;
+        work_count--;
+        work_busy[id] = pt;
+        pthread_mutex_unlock(&work_mutex);
+
+        /* 不持有任何锁，回调可以阻塞 */
+        pt->cb(pt);
+
+        pthread_mutex_lock(&work_mutex);
+        work_busy[id] = NULL;
+    }
+    pthread_mutex_unlock(&work_mutex);
+
+    return NULL;
+}
+
+/**
+ * @brief 调度线程，同步滴答时钟、轮询定时器，然后休眠到最近的到期时刻
+ * @param[in] arg 未使用
+ * @return 无
+ */
+static void* letk_timer_linux_dispatcher(void* arg)
+{
+    uint32_t next;
+    uint64_t wake_ns;
+    struct timespec ts;
+
+    (void)arg;
+
+    pthread_mutex_lock(&svc_mutex);
+    while (svc_running)
+    {
+        letk_timer_linux_sync_ticks();
+        letk_timer_poll();
+
+        next = letk_timer_next_expiry_ms();
+        if (next == LETK_TIMER_NEXT_NONE)
+        {
+            /* 没有运行中的定时器，等待其他线程唤醒 */
+            pthread_cond_wait(&svc_cond, &svc_mutex);
+        }
+        else
+        {
+            if (next == 0)
+            {
+                /* 轮询后仍有已到期的定时器(例如周期为0)，滴答时钟前进之前再轮询也不会有变化，
+                 * 至少休眠到下一个ms边界，避免空转占满一个核 */
+                next = 1;
+            }
+            /* 以滴答时钟的同步时刻为基准，到期时刻对齐到ms边界 */
+            wake_ns = svc_sync_ns + (uint64_t)next * 1000000u;
+            ts.tv_sec = (time_t)(wake_ns / 1000000000u);
+            ts.tv_nsec = (long)(wake_ns % 1000000000u);
+            pthread_cond_timedwait(&svc_cond, &svc_mutex, &ts);
+        }
+    }
+    pthread_mutex_unlock(&svc_mutex);
+
+    return NULL;
+}
+
+/**
+ * @brief 启动定时器服务，创建调度线程和工作线程
+ * @return 是否成功
+ */
+bool letk_timer_linux_start(void)
+{
+    pthread_condattr_t attr;
+    uint32_t i;
+
+    /* 持有服务锁直到启动完成，调度线程在此之前不会开始轮询 */
+    pthread_mutex_lock(&svc_mutex);
+    if (svc_running)
+    {
+        pthread_mutex_unlock(&svc_mutex);
+        return true;
+    }
+
+    /* 休眠使用单调时钟，不受系统时间调整影响 */
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&svc_cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    svc_sync_ns = letk_timer_linux_now_ns();
+    letk_timer_set_offload_cb(letk_timer_linux_offload);
+
+    pthread_mutex_lock(&work_mutex);
+    svc_running = true;
+    pthread_mutex_unlock(&work_mutex);
+    for (i = 0; i < LETK_TIMER_LINUX_WORKERS; i++)
+    {
+        work_busy[i] = NULL;
+        if (pthread_create(&work_thread[i], NULL, letk_timer_linux_worker, (void*)(uintptr_t)i) != 0)
+        {
+            break;
+        }
+    }
+    if ((i < LETK_TIMER_LINUX_WORKERS) ||
+        (pthread_create(&svc_thread, NULL, letk_timer_linux_dispatcher, NULL) != 0))
+    {
+        /* 创建失败，回收已创建的工作线程 */
+        pthread_mutex_lock(&work_mutex);
+        svc_running = false;
+        pthread_cond_broadcast(&work_cond);
+        pthread_mutex_unlock(&work_mutex);
+        while (i > 0)
+        {
+            pthread_join(work_thread[--i], NULL);
+        }
+        letk_timer_set_offload_cb(NULL);
+        pthread_cond_destroy(&svc_cond);
+        pthread_mutex_unlock(&svc_mutex);
+        return false;
+    }
+
+    pthread_mutex_unlock(&svc_mutex);
+    return true;
+}
+
+/**
+ * @brief 停止定时器服务，等待全部线程退出
+ */
+void letk_timer_linux_stop(void)
+{
+    uint32_t i;
+
+    pthread_mutex_lock(&svc_mutex);
+    if (!svc_running)
+    {
+        pthread_mutex_unlock(&svc_mutex);
+        return;
+    }
+    pthread_mutex_lock(&work_mutex);
+    svc_running = false;
+    pthread_cond_broadcast(&work_cond);
+    pthread_mutex_unlock(&work_mutex);
+    pthread_cond_signal(&svc_cond);
+    pthread_mutex_unlock(&svc_mutex);
+
+    pthread_join(svc_thread, NULL);
+    for (i = 0; i < LETK_TIMER_LINUX_WORKERS; i++)
+    {
+        pthread_join(work_thread[i], NULL);
+    }
+
+    /* 未运行的卸载回调丢弃 */
+    work_front = 0;
+    work_count = 0;
+    letk_timer_set_offload_cb(NULL);
+    pthread_cond_destroy(&svc_cond);
+}
+
+/**
+ * @brief 获取被合并掉的卸载回调次数
+ * @return 上一次还没运行完或卸载队列已满而没有运行的回调次数
+ */
+uint32_t letk_timer_linux_get_skipped(void)
+{
+    uint32_t count;
+
+    pthread_mutex_lock(&work_mutex);
+    count = work_skipped;
+    pthread_mutex_unlock(&work_mutex);
+    return count;
+}
+
+/**
+ * @brief 获取定时器服务锁
+ */
+void letk_timer_linux_lock(void)
+{
+    pthread_mutex_lock(&svc_mutex);
+}
+
+/**
+ * @brief 释放定时器服务锁，并唤醒调度线程重新计算最近到期时刻
+ */
+void letk_timer_linux_unlock(void)
+{
+    pthread_cond_signal(&svc_cond);
+    pthread_mutex_unlock(&svc_mutex);
+}
+
+#ifdef __cplusplus
+}
+#endif  /* __cplusplus */
+
+#endif  /* LETK_TIMER_LINUX_ENABLE */
@@ -0,0 +1,90 @@
+/***********************************************************************************************************************
+** 文件描述：Linux主机定时器服务头文件，调度线程驱动滴答时钟和定时器轮询，卸载的回调由工作线程池运行
+** 创建作者：付瑞彪(Tom Free)
+** 创建日期：2026年10月18日
+** 编码格式：UTF-8编码
+** 编程语言：C语言，C99标准
+** 缩进格式：4个空格键
+** 命名规范：下划线命名法(小写命名法)
+** 开源许可：MIT许可证，参考：https://mit-license.org
+** 版权信息：Copyright (c) 2013-2022, Tom Free, <tomfreefu@gmail.com>
+**
+** 修改记录
+** 修改日期         修改作者        修改内容
+** 2026年10月18日   付瑞彪          创建文件，初次版本
+** 2026年10月18日   付瑞彪          增加被合并的卸载回调次数查询
+**
+***********************************************************************************************************************/
+#ifndef __LETK_TIMER_LINUX_H__
+#define __LETK_TIMER_LINUX_H__
+
+#include "letk_timer.h"
+
+/* 默认不使能Linux定时器服务 */
+#ifndef LETK_TIMER_LINUX_ENABLE
+#define LETK_TIMER_LINUX_ENABLE         0
+#endif  /* LETK_TIMER_LINUX_ENABLE */
+
+#if LETK_TIMER_LINUX_ENABLE
+
+#if !LETK_TIMER_OFFLOAD_ENABLE
+#error LETK_TIMER_LINUX_ENABLE requires LETK_TIMER_OFFLOAD_ENABLE
+#endif
+
+/* 默认2个工作线程 */
+#ifndef LETK_TIMER_LINUX_WORKERS
+#define LETK_TIMER_LINUX_WORKERS        2
+#endif  /* LETK_TIMER_LINUX_WORKERS */
+
+/* 默认卸载队列长度 */
+#ifndef LETK_TIMER_LINUX_QUEUE_SIZE
+#define LETK_TIMER_LINUX_QUEUE_SIZE     16
+#endif  /* LETK_TIMER_LINUX_QUEUE_SIZE */
+
+#if (LETK_TIMER_LINUX_WORKERS < 1) || (LETK_TIMER_LINUX_QUEUE_SIZE < 1)
+#error LETK_TIMER_LINUX_WORKERS and LETK_TIMER_LINUX_QUEUE_SIZE must be at least 1
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif  /* __cplusplus */
+
+/**
+ * @brief 启动定时器服务，创建调度线程和工作线程
+ * @return 是否成功
+ * @note 启动后由服务负责调用letk_ticks_inc_ms和letk_timer_poll，用户不要再调用，
+ *       卸载执行的定时器从链表移除后，工作线程中可能还有一次回调在运行或排队，释放前需要自行同步
+ */
+bool letk_timer_linux_start(void);
+
+/**
+ * @brief 停止定时器服务，等待全部线程退出
+ * @note 不能在定时器回调中调用
+ */
+void letk_timer_linux_stop(void);
+
+/**
+ * @brief 获取被合并掉的卸载回调次数
+ * @return 上一次还没运行完或卸载队列已满而没有运行的回调次数
+ * @note 卸载执行的回调不会在调度线程中运行，队列满时本次回调被合并，周期定时器下一周期照常投递
+ */
+uint32_t letk_timer_linux_get_skipped(void);
+
+/**
+ * @brief 获取定时器服务锁，其他线程调用定时器接口前必须先加锁
+ * @note 直接运行的回调已在锁内，不能再加锁；卸载执行的回调在工作线程中运行，需要加锁
+ */
+void letk_timer_linux_lock(void);
+
+/**
+ * @brief 释放定时器服务锁，并唤醒调度线程重新计算最近到期时刻
+ */
+void letk_timer_linux_unlock(void);
+
+#ifdef __cplusplus
+}
+#endif  /* __cplusplus */
+
+#endif  /* LETK_TIMER_LINUX_ENABLE */
+
+#endif  /* __LETK_TIMER_LINUX_H__ */
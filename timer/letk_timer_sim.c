@@ -0,0 +1,81 @@
+/***********************************************************************************************************************
+** 文件描述：定时器虚拟时间仿真源文件，时间只在需要时前进，直接跳到下一个定时器到期时刻，用于主机上快速确定地运行长时间测试
+** 创建作者：付瑞彪(Tom Free)
+** 创建日期：2026年10月18日
+** 编码格式：UTF-8编码
+** 编程语言：C语言，C99标准
+** 缩进格式：4个空格键
+** 命名规范：下划线命名法(小写命名法)
+** 开源许可：MIT许可证，参考：https://mit-license.org
+** 版权信息：Copyright (c) 2013-2022, Tom Free, <tomfreefu@gmail.com>
+**
+** 修改记录
+** 修改日期         修改作者        修改内容
+** 2026年10月18日   付瑞彪          创建文件，初次版本
+**
+***********************************************************************************************************************/
+#include "letk_timer_sim.h"
+
+#if LETK_TIMER_SIM_ENABLE
+
+#include "letk_ticks.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  /* __cplusplus */
+
+/**
+ * @brief 轮询一次定时器，然后把时间直接推进到下一个定时器到期时刻
+ * @param[in] limit_ms 最多推进的ms数
+ * @return 实际推进的ms数
+ */
+uint32_t letk_timer_sim_step(uint32_t limit_ms)
+{
+    uint32_t next;
+
+    letk_timer_poll();
+
+    next = letk_timer_next_expiry_ms();
+    if (next == 0)
+    {
+        /* 轮询后仍有到期的定时器(例如间隔为0)，按一个滴答推进，防止时间停滞 */
+        next = 1;
+    }
+    if (next > limit_ms)
+    {
+        /* 包含没有运行中定时器的情况 */
+        next = limit_ms;
+    }
+    if (next > 0)
+    {
+        letk_ticks_inc_ms(next);
+    }
+
+    return next;
+}
+
+/**
+ * @brief 运行指定的仿真时间
+ * @param[in] ms 仿真的ms数
+ * @return 轮询次数
+ */
+uint32_t letk_timer_sim_run(uint32_t ms)
+{
+    uint32_t polls = 0;
+
+    while (ms > 0)
+    {
+        ms -= letk_timer_sim_step(ms);
+        polls++;
+    }
+    /* 结束时刻到期的定时器 */
+    letk_timer_poll();
+
+    return polls + 1;
+}
+
+#ifdef __cplusplus
+}
+#endif  /* __cplusplus */
+
+#endif  /* LETK_TIMER_SIM_ENABLE */
@@ -0,0 +1,54 @@
+/***********************************************************************************************************************
+** 文件描述：定时器虚拟时间仿真头文件，时间只在需要时前进，直接跳到下一个定时器到期时刻，用于主机上快速确定地运行长时间测试
+** 创建作者：付瑞彪(Tom Free)
+** 创建日期：2026年10月18日
+** 编码格式：UTF-8编码
+** 编程语言：C语言，C99标准
+** 缩进格式：4个空格键
+** 命名规范：下划线命名法(小写命名法)
+** 开源许可：MIT许可证，参考：https://mit-license.org
+** 版权信息：Copyright (c) 2013-2022, Tom Free, <tomfreefu@gmail.com>
+**
+** 修改记录
+** 修改日期         修改作者        修改内容
+** 2026年10月18日   付瑞彪          创建文件，初次版本
+**
+***********************************************************************************************************************/
+#ifndef __LETK_TIMER_SIM_H__
+#define __LETK_TIMER_SIM_H__
+
+#include "letk_timer.h"
+
+/* 默认不使能虚拟时间仿真 */
+#ifndef LETK_TIMER_SIM_ENABLE
+#define LETK_TIMER_SIM_ENABLE           0
+#endif  /* LETK_TIMER_SIM_ENABLE */
+
+#if LETK_TIMER_SIM_ENABLE
+
+#ifdef __cplusplus
+extern "C" {
+#endif  /* __cplusplus */
+
+/**
+ * @brief 轮询一次定时器，然后把时间直接推进到下一个定时器到期时刻
+ * @param[in] limit_ms 最多推进的ms数
+ * @return 实际推进的ms数，已有定时器到期时至少推进1ms
+ */
+uint32_t letk_timer_sim_step(uint32_t limit_ms);
+
+/**
+ * @brief 运行指定的仿真时间，期间所有到期的定时器按时触发，结束时刻也会轮询一次
+ * @param[in] ms 仿真的ms数
+ * @return 轮询次数
+ * @note 按键等需要周期扫描的模块，用一个周期定时器调用其轮询函数即可
+ */
+uint32_t letk_timer_sim_run(uint32_t ms);
+
+#ifdef __cplusplus
+}
+#endif  /* __cplusplus */
+
+#endif  /* LETK_TIMER_SIM_ENABLE */
+
+#endif  /* __LETK_TIMER_SIM_H__ */
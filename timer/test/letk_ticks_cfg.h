@@ -0,0 +1,23 @@
+/***********************************************************************************************************************
+** 文件描述：定时器引擎对照测试使用的系统滴答时钟配置文件
+** 创建作者：付瑞彪(Tom Free)
+** 创建日期：2026年10月18日
+** 编码格式：UTF-8编码
+** 编程语言：C语言，C99标准
+** 缩进格式：4个空格键
+** 命名规范：下划线命名法(小写命名法)
+** 开源许可：MIT许可证，参考：https://mit-license.org
+** 版权信息：Copyright (c) 2013-2022, Tom Free, <tomfreefu@gmail.com>
+**
+** 修改记录
+** 修改日期         修改作者        修改内容
+** 2026年10月18日   付瑞彪          创建文件，初次版本
+**
+***********************************************************************************************************************/
+#ifndef __LETK_TICKS_CFG_H__
+#define __LETK_TICKS_CFG_H__
+
+/* 单线程运行，不需要序号锁 */
+#define LETK_TICKS_SEQLOCK_ENABLE       0
+
+#endif  /* __LETK_TICKS_CFG_H__ */
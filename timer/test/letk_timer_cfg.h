@@ -0,0 +1,28 @@
+/***********************************************************************************************************************
+** 文件描述：定时器引擎对照测试使用的配置文件，其余配置项使用letk_timer.h中的默认值
+** 创建作者：付瑞彪(Tom Free)
+** 创建日期：2026年10月18日
+** 编码格式：UTF-8编码
+** 编程语言：C语言，C99标准
+** 缩进格式：4个空格键
+** 命名规范：下划线命名法(小写命名法)
+** 开源许可：MIT许可证，参考：https://mit-license.org
+** 版权信息：Copyright (c) 2013-2022, Tom Free, <tomfreefu@gmail.com>
+**
+** 修改记录
+** 修改日期         修改作者        修改内容
+** 2026年10月18日   付瑞彪          创建文件，初次版本
+**
+***********************************************************************************************************************/
+#ifndef __LETK_TIMER_CFG_H__
+#define __LETK_TIMER_CFG_H__
+
+/* 调度引擎由编译命令行-DLETK_TIMER_ENGINE=n指定，0：链表，1：时间轮，2：最小堆 */
+#ifndef LETK_TIMER_ENGINE
+#define LETK_TIMER_ENGINE               LETK_TIMER_ENGINE_LIST
+#endif  /* LETK_TIMER_ENGINE */
+
+/* 定时器池，用于延时调用和周期调用的释放后复用 */
+#define LETK_TIMER_POOL_SIZE            8
+
+#endif  /* __LETK_TIMER_CFG_H__ */
@@ -0,0 +1,202 @@
+/***********************************************************************************************************************
+** 文件描述：定时器引擎对照测试，同一组场景分别用三种调度引擎运行，触发次数必须与期望值一致
+** 创建作者：付瑞彪(Tom Free)
+** 创建日期：2026年10月18日
+** 编码格式：UTF-8编码
+** 编程语言：C语言，C99标准
+** 缩进格式：4个空格键
+** 命名规范：下划线命名法(小写命名法)
+** 开源许可：MIT许可证，参考：https://mit-license.org
+** 版权信息：Copyright (c) 2013-2022, Tom Free, <tomfreefu@gmail.com>
+**
+** 修改记录
+** 修改日期         修改作者        修改内容
+** 2026年10月18日   付瑞彪          创建文件，初次版本
+**
+***********************************************************************************************************************/
+#include "letk_timer.h"
+#include "letk_ticks.h"
+#include <stdio.h>
+
+/* 每个场景运行的ms数，每次轮询前推进1ms */
+#define TEST_RUN_MS             1000u
+/* 周期定时器的周期 */
+#define TEST_PERIOD             10u
+/* 与被复用定时器同时到期的旁观定时器数量 */
+#define TEST_BYSTANDERS         6u
+
+#if LETK_TIMER_ENGINE == LETK_TIMER_ENGINE_LIST
+#define TEST_ENGINE_NAME        "list"
+#elif LETK_TIMER_ENGINE == LETK_TIMER_ENGINE_WHEEL
+#define TEST_ENGINE_NAME        "wheel"
+#else
+#define TEST_ENGINE_NAME        "heap"
+#endif  /* LETK_TIMER_ENGINE */
+
+/* 触发回调的定时器 */
+static letk_timer_t test_timer_a;
+/* 在回调中被复用的定时器 */
+static letk_timer_t test_timer_b;
+/* 旁观定时器 */
+static letk_timer_t test_bystanders[TEST_BYSTANDERS];
+/* 旁观定时器的触发次数 */
+static uint32_t test_bystander_count[TEST_BYSTANDERS];
+/* 触发回调的定时器的触发次数 */
+static uint32_t test_a_count;
+/* 在回调中被复用的周期调用的ID */
+static letk_timer_id_t test_call_id;
+/* 失败次数 */
+static uint32_t test_fails;
+
+/**
+ * @brief 检查一个触发次数，不一致时打印并记录失败
+ * @param[in] scene 场景名称
+ * @param[in] name 定时器名称
+ * @param[in] actual 实际的触发次数
+ * @param[in] expect 期望的触发次数
+ */
+static void test_check(const char* scene, const char* name, uint32_t actual, uint32_t expect)
+{
+    if (actual != expect)
+    {
+        printf("FAIL %s %s: %s fired %lu times, expect %lu\n", TEST_ENGINE_NAME, scene, name,
+               (unsigned long)actual, (unsigned long)expect);
+        test_fails++;
+    }
+}
+
+/**
+ * @brief 旁观定时器回调，按用户数据中的序号计数
+ * @param[in] ptimer 定时器指针
+ */
+static void test_bystander_cb(letk_timer_t* ptimer)
+{
+    test_bystander_count[(uint32_t)(uintptr_t)ptimer->user_data]++;
+}
+
+/**
+ * @brief 被复用定时器的回调，不做任何事
+ * @param[in] ptimer 定时器指针
+ */
+static void test_b_cb(letk_timer_t* ptimer)
+{
+    (void)ptimer;
+}
+
+/**
+ * @brief 在回调中移除定时器B，重新初始化后添加并启动
+ * @param[in] ptimer 定时器指针
+ */
+static void test_reuse_cb(letk_timer_t* ptimer)
+{
+    (void)ptimer;
+    test_a_count++;
+    letk_timer_remove(&test_timer_b);
+    letk_timer_init(&test_timer_b, -1, TEST_PERIOD, test_b_cb, NULL);
+    letk_timer_add(&test_timer_b);
+    letk_timer_start(&test_timer_b);
+}
+
+/**
+ * @brief 周期调用的回调，不做任何事
+ * @param[in] arg 未使用
+ */
+static void test_call_cb(void* arg)
+{
+    (void)arg;
+}
+
+/**
+ * @brief 在回调中取消周期调用，立即重新申请，释放的节点被重新初始化
+ * @param[in] ptimer 定时器指针
+ */
+static void test_pool_cb(letk_timer_t* ptimer)
+{
+    (void)ptimer;
+    test_a_count++;
+    letk_timer_cancel(test_call_id);
+    test_call_id = letk_timer_call_every(TEST_PERIOD, test_call_cb, NULL);
+}
+
+/**
+ * @brief 添加并启动旁观定时器，清零计数
+ */
+static void test_add_bystanders(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < TEST_BYSTANDERS; i++)
+    {
+        letk_timer_init(&test_bystanders[i], -1, TEST_PERIOD, test_bystander_cb, (void*)(uintptr_t)i);
+        letk_timer_add(&test_bystanders[i]);
+        letk_timer_start(&test_bystanders[i]);
+        test_bystander_count[i] = 0;
+    }
+}
+
+/**
+ * @brief 运行一个场景，结束后检查触发次数并移除全部定时器
+ * @param[in] scene 场景名称
+ */
+static void test_run(const char* scene)
+{
+    char name[16];
+    uint32_t i;
+
+    for (i = 0; i < TEST_RUN_MS; i++)
+    {
+        letk_ticks_inc_ms(1);
+        letk_timer_poll();
+    }
+
+    test_check(scene, "a", test_a_count, TEST_RUN_MS / TEST_PERIOD);
+    for (i = 0; i < TEST_BYSTANDERS; i++)
+    {
+        snprintf(name, sizeof(name), "bystander%lu", (unsigned long)i);
+        test_check(scene, name, test_bystander_count[i], TEST_RUN_MS / TEST_PERIOD);
+    }
+    letk_timer_remove_all();
+}
+
+/**
+ * @brief 回调中移除、重新初始化并重新添加同一轮到期的定时器，其余同时到期的定时器照常触发
+ */
+static void test_reuse(void)
+{
+    test_a_count = 0;
+    letk_timer_init(&test_timer_a, -1, TEST_PERIOD, test_reuse_cb, NULL);
+    letk_timer_add(&test_timer_a);
+    letk_timer_start(&test_timer_a);
+    letk_timer_init(&test_timer_b, -1, TEST_PERIOD, test_b_cb, NULL);
+    letk_timer_add(&test_timer_b);
+    letk_timer_start(&test_timer_b);
+    test_add_bystanders();
+    test_run("reuse");
+}
+
+/**
+ * @brief 回调中取消同一轮到期的周期调用并立即重新申请，其余同时到期的定时器照常触发
+ */
+static void test_pool_reuse(void)
+{
+    test_a_count = 0;
+    letk_timer_init(&test_timer_a, -1, TEST_PERIOD, test_pool_cb, NULL);
+    letk_timer_add(&test_timer_a);
+    letk_timer_start(&test_timer_a);
+    test_call_id = letk_timer_call_every(TEST_PERIOD, test_call_cb, NULL);
+    test_add_bystanders();
+    test_run("pool-reuse");
+}
+
+/**
+ * @brief 主函数
+ * @return 0：通过，1：失败
+ */
+int main(void)
+{
+    test_reuse();
+    test_pool_reuse();
+
+    printf("%s %s\n", TEST_ENGINE_NAME, (test_fails == 0) ? "PASS" : "FAIL");
+    return (test_fails == 0) ? 0 : 1;
+}
@@ -0,0 +1,12 @@
+#!/bin/sh
+# 在主机上编译并运行定时器引擎对照测试，分别用三种调度引擎编译，任一引擎失败时返回非0
+# 用法：sh timer/test/run.sh，编译器由环境变量CC指定，默认cc，额外的编译选项由环境变量CFLAGS指定
+set -e
+cd "$(dirname "$0")"
+CC=${CC:-cc}
+OUT=${TMPDIR:-/tmp}
+for engine in 0 1 2; do
+    $CC -std=c99 -O2 -Wall $CFLAGS -DLETK_TIMER_ENGINE=$engine -I. -I.. -I../../ticks \
+        ../letk_timer.c ../../ticks/letk_ticks.c letk_timer_test.c -o "$OUT/letk_timer_test_$engine"
+    "$OUT/letk_timer_test_$engine"
+done